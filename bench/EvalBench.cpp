@@ -0,0 +1,168 @@
+/**
+ * @file EvalBench.cpp
+ * @brief Measures the vectorized evaluation of Connect 4 boards against the incremental one.
+ *
+ * Random positions of the classic board are scored three ways:
+ * - every child made, evaluated and undone, the heuristic being updated incrementally;
+ * - the children of each position scored together with `evaluateMoves()`;
+ * - all the children of all the positions scored in one call, with each supported kernel.
+ * The batched scores are checked against the incremental ones.
+ *
+ * Usage: `eval_bench [positions] [seed]`
+ */
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Connect4.h"
+#include "Connect4Eval.h"
+
+namespace
+{
+    using Layout = Connect4Layout::Layout<7, 6, 4>; ///< The layout of the classic board.
+
+    /**
+     * @struct Timing
+     * @brief The time spent scoring the boards one way.
+     */
+    struct Timing {
+        double seconds = 0; ///< The total time.
+        long long boards = 0; ///< The number of boards scored.
+        long long checksum = 0; ///< The sum of the scores, so the work is not optimized away.
+    };
+
+    /**
+     * @brief Prints one way of scoring the boards.
+     * @param name The name of the way.
+     * @param timing Its timing.
+     */
+    void print(const std::string &name, const Timing &timing)
+    {
+        std::cout << std::left << std::setw(28) << name << std::right
+                  << std::setw(12) << std::setprecision(1) << timing.seconds * 1e9 / timing.boards
+                  << std::setw(16) << std::setprecision(0) << timing.boards / timing.seconds
+                  << std::setw(14) << timing.checksum << "\n";
+    }
+}
+
+/**
+ * @brief Runs the evaluation benchmark.
+ *
+ * @param argc The number of command-line arguments.
+ * @param argv The command-line arguments: the number of positions and the seed, both optional.
+ * @return int Exit status of the program: 1 if a batched score differs from the incremental one.
+ */
+int main(const int argc, char* argv[])
+{
+    const int positionCount = argc > 1 ? std::stoi(argv[1]) : 100000;
+    const uint64_t seed = argc > 2 ? std::stoull(argv[2]) : 1;
+
+    // Positions of random games, and the bitboards of their children.
+    std::mt19937_64 random(seed);
+    std::vector<Connect4> positions;
+    std::vector<uint64_t> aiBoards;
+    std::vector<uint64_t> playerBoards;
+    std::vector<int> expected;
+    positions.reserve(positionCount);
+    while (static_cast<int>(positions.size()) < positionCount)
+    {
+        Connect4 game(random() % 2 == 0);
+        uint64_t ai = 0;
+        uint64_t player = 0;
+        int heights[Connect4::WIDTH] = {};
+        while (!game.isTerminal() && static_cast<int>(positions.size()) < positionCount)
+        {
+            positions.push_back(game);
+            MoveList moves;
+            game.generateMoves(moves);
+            for (int i = 0; i < moves.size(); ++i)
+            {
+                const uint64_t piece = uint64_t{1} << (moves[i] * Connect4::COLUMN_BITS + heights[moves[i]]);
+                aiBoards.push_back(game.getCurrentPlayer() == game.AI ? ai | piece : ai);
+                playerBoards.push_back(game.getCurrentPlayer() == game.PLAYER ? player | piece : player);
+                game.makeMove(moves[i]);
+                expected.push_back(game.evaluate());
+                game.undoMove(moves[i]);
+            }
+
+            const int move = moves[static_cast<int>(random() % moves.size())];
+            const uint64_t piece = uint64_t{1} << (move * Connect4::COLUMN_BITS + heights[move]++);
+            (game.getCurrentPlayer() == game.AI ? ai : player) |= piece;
+            game.makeMove(move);
+        }
+    }
+
+    std::cout << "kernel: " << Connect4Eval::kernelName(Connect4Eval::activeKernel()) << ", "
+              << positions.size() << " positions, " << expected.size() << " children\n";
+    std::cout << std::left << std::setw(28) << "method" << std::right << std::setw(12) << "ns/board"
+              << std::setw(16) << "boards/s" << std::setw(14) << "checksum" << "\n";
+    std::cout << std::fixed;
+
+    long long mismatches = 0;
+    Timing incremental;
+    auto start = std::chrono::steady_clock::now();
+    for (Connect4 &game : positions)
+    {
+        MoveList moves;
+        game.generateMoves(moves);
+        for (int i = 0; i < moves.size(); ++i)
+        {
+            game.makeMove(moves[i]);
+            incremental.checksum += game.evaluate();
+            game.undoMove(moves[i]);
+        }
+        incremental.boards += moves.size();
+    }
+    incremental.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    print("make/evaluate/undo", incremental);
+
+    Timing children;
+    std::size_t next = 0;
+    start = std::chrono::steady_clock::now();
+    for (const Connect4 &game : positions)
+    {
+        MoveList moves;
+        game.generateMoves(moves);
+        int scores[MAX_MOVES];
+        bool terminal[MAX_MOVES];
+        game.evaluateMoves(moves, scores, terminal);
+        for (int i = 0; i < moves.size(); ++i)
+        {
+            children.checksum += scores[i];
+            mismatches += scores[i] != expected[next++];
+        }
+        children.boards += moves.size();
+    }
+    children.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    print("evaluateMoves", children);
+
+    std::vector<int> scores(expected.size());
+    for (const Connect4Eval::Kernel kernel : {Connect4Eval::Kernel::Scalar, Connect4Eval::Kernel::Sse2,
+                                              Connect4Eval::Kernel::Neon, Connect4Eval::Kernel::Avx2})
+    {
+        if (!Connect4Eval::isSupported(kernel)) continue;
+
+        Timing batch;
+        start = std::chrono::steady_clock::now();
+        Connect4Eval::evaluateBoards<Layout>(aiBoards.data(), playerBoards.data(), expected.size(), scores.data(), kernel);
+        batch.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        batch.boards = static_cast<long long>(expected.size());
+        for (std::size_t i = 0; i < expected.size(); ++i)
+        {
+            batch.checksum += scores[i];
+            mismatches += scores[i] != expected[i];
+        }
+        print(std::string("evaluateBoards (") + Connect4Eval::kernelName(kernel) + ")", batch);
+    }
+
+    if (mismatches > 0)
+    {
+        std::cout << mismatches << " batched scores differ from the incremental evaluation.\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,96 @@
+/**
+ * @file ScalingBench.cpp
+ * @brief Measures how the parallel Connect 4 search scales with the number of threads.
+ *
+ * Each thread count searches the same positions to the same fixed depth with a fresh engine,
+ * and the time to depth is compared with the single-threaded search.
+ *
+ * Usage: `scaling_bench [depth] [hash MiB]`
+ */
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "AlphaBeta.h"
+#include "Connect4.h"
+
+namespace
+{
+    /// Positions of the suite, as the columns played from the empty board (0-based).
+    constexpr const char* POSITIONS[] = {"", "3", "33", "332", "3324", "23344", "334452", "0123456"};
+
+    constexpr int THREAD_COUNTS[] = {1, 2, 4, 8, 16, 32}; ///< The thread counts measured.
+
+    /**
+     * @struct RunResult
+     * @brief The totals of one pass over the suite.
+     */
+    struct RunResult {
+        double seconds = 0; ///< The total time to depth.
+        long long nodes = 0; ///< The total number of nodes, over all threads.
+    };
+
+    /**
+     * @brief Searches every position of the suite.
+     * @param limits The limits of each search.
+     * @param ttSizeMb The size of the transposition table, in MiB.
+     * @return The totals of the pass.
+     */
+    RunResult runSuite(const SearchLimits &limits, const std::size_t ttSizeMb)
+    {
+        RunResult result;
+        for (const char* position : POSITIONS)
+        {
+            // The AI moves first, so that it is the player to move after an even number of moves.
+            Connect4 game(std::string(position).size() % 2 != 0);
+            for (const char* c = position; *c; ++c) game.makeMove(*c - '0');
+
+            AlphaBeta<Connect4> engine(ttSizeMb);
+            const auto start = std::chrono::steady_clock::now();
+            (void) engine.getBestMove(game, limits);
+            result.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            result.nodes += engine.getNodeCount();
+        }
+        return result;
+    }
+}
+
+/**
+ * @brief Runs the scaling benchmark for both parallel modes.
+ *
+ * @param argc The number of command-line arguments.
+ * @param argv The command-line arguments: the search depth and the table size, both optional.
+ * @return int Exit status of the program.
+ */
+int main(const int argc, char* argv[])
+{
+    const int depth = argc > 1 ? std::stoi(argv[1]) : 12;
+    const std::size_t ttSizeMb = argc > 2 ? std::stoul(argv[2]) : 64;
+
+    std::cout << std::left << std::setw(12) << "mode" << std::right << std::setw(8) << "threads" << std::setw(12) << "time (s)"
+              << std::setw(10) << "speedup" << std::setw(14) << "nodes" << std::setw(14) << "nodes/s" << "\n";
+    std::cout << std::fixed;
+    for (const ParallelMode mode : {ParallelMode::LazySmp, ParallelMode::RootSplit})
+    {
+        double baseline = 0;
+        for (const int threads : THREAD_COUNTS)
+        {
+            SearchLimits limits;
+            limits.maxDepth = depth;
+            limits.threads = threads;
+            limits.parallelMode = mode;
+
+            const RunResult result = runSuite(limits, ttSizeMb);
+            if (threads == 1) baseline = result.seconds;
+            std::cout << std::left << std::setw(12) << (mode == ParallelMode::LazySmp ? "lazy-smp" : "root-split")
+                      << std::right << std::setw(8) << threads
+                      << std::setw(12) << std::setprecision(3) << result.seconds
+                      << std::setw(10) << std::setprecision(2) << baseline / result.seconds
+                      << std::setw(14) << result.nodes
+                      << std::setw(14) << std::setprecision(0) << result.nodes / result.seconds << "\n";
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,126 @@
+/**
+ * @file SearchBench.cpp
+ * @brief Measures the search on fixed suites of positions of every game.
+ *
+ * Each case searches one position with a fresh engine, either to a fixed depth or for a fixed
+ * time, and prints one JSON object per line, so that the results of two builds can be compared
+ * by a script:
+ *
+ *     {"game":"connect4","position":"3 3 2","depth":10,"time_ms":0,"completed_depth":10,"move":3,
+ *      "score":4,"nodes":81234,"seconds":0.0102,"nps":7964117,"max_depth":10,"leaf_evaluations":51210,
+ *      "cutoffs":14020,"tt_probes":60123,"tt_hits":20456,"tt_hit_rate":0.3402,"pv":"3 2 4 3"}
+ *
+ * `seconds` is the time to depth of the depth-limited cases. The counters other than the node
+ * count are 0 when the search statistics are compiled out. `pv` is the principal variation.
+ *
+ * Usage: `search_bench [hash MiB] [threads] [pvs|alphabeta]`. `alphabeta` turns off the
+ * principal variation search and the aspiration windows, to compare with plain alpha-beta.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "AlphaBeta.h"
+#include "Connect4.h"
+#include "SticksGame.h"
+#include "TicTacToe.h"
+
+namespace
+{
+    /**
+     * @struct BenchCase
+     * @brief One search of the suite.
+     */
+    struct BenchCase {
+        const char* position; ///< The moves played from the initial position, separated by spaces.
+        int depth; ///< The depth limit, or 0 for the default depth of the game.
+        int timeMs; ///< The time budget, in milliseconds, or 0 for no limit.
+    };
+
+    /// Tic-Tac-Toe positions, as cell indices, searched until the end.
+    constexpr BenchCase TIC_TAC_TOE_SUITE[] = {{"", 0, 0}, {"4", 0, 0}, {"0 4", 0, 0}, {"0 4 8", 0, 0}, {"4 0 2 6", 0, 0}};
+
+    /// Connect 4 positions, as columns, searched to fixed depths and for fixed times.
+    constexpr BenchCase CONNECT4_SUITE[] = {
+        {"", 10, 0}, {"3", 10, 0}, {"3 3", 10, 0}, {"3 3 2", 10, 0}, {"3 3 2 4", 12, 0},
+        {"2 3 3 4 4", 12, 0}, {"3 2 4 4 2 3", 12, 0}, {"0 1 2 3 4 5 6", 12, 0},
+        {"", 0, 100}, {"3 3 2 4", 0, 100}, {"0 1 2 3 4 5 6", 0, 100},
+    };
+
+    /// Sticks game positions, as the numbers of sticks taken, searched until the end.
+    constexpr BenchCase STICKS_SUITE[] = {{"", 0, 0}, {"1", 0, 0}, {"3 2", 0, 0}, {"1 1 1 1", 0, 0}};
+
+    /**
+     * @brief Runs one case and prints its result line.
+     * @tparam TGame The concrete game type.
+     * @param name The name of the game in the output.
+     * @param benchCase The case to run.
+     * @param ttSizeMb The size of the transposition table, in MiB.
+     * @param threads The number of search threads.
+     * @param plain Whether to search with plain alpha-beta, without null windows nor aspiration windows.
+     */
+    template <typename TGame>
+    void runCase(const char* name, const BenchCase &benchCase, const std::size_t ttSizeMb, const int threads,
+                 const bool plain)
+    {
+        // The AI starts, so that it moves after an even number of moves and the player after an odd one.
+        TGame game(false);
+        std::istringstream moves(benchCase.position);
+        for (int move; moves >> move;) game.makeMove(move);
+
+        SearchLimits limits = SearchLimits::defaults<TGame>();
+        if (benchCase.depth > 0) limits.maxDepth = benchCase.depth;
+        limits.timeBudget = std::chrono::milliseconds(benchCase.timeMs);
+        limits.threads = threads;
+        limits.principalVariationSearch = !plain;
+        limits.aspirationWindows = !plain;
+
+        AlphaBeta<TGame> engine(ttSizeMb);
+        const SearchResult result = engine.findBestMove(game, limits);
+        const SearchStats &stats = result.stats;
+        const double seconds = std::chrono::duration<double>(stats.elapsed).count();
+        std::ostringstream line;
+        for (std::size_t i = 0; i < result.principalVariation.size(); ++i)
+        {
+            line << (i > 0 ? " " : "") << result.principalVariation[i];
+        }
+        std::cout << "{\"game\":\"" << name << "\",\"position\":\"" << benchCase.position << "\""
+                  << ",\"depth\":" << (benchCase.depth > 0 ? benchCase.depth : 0)
+                  << ",\"time_ms\":" << benchCase.timeMs
+                  << ",\"completed_depth\":" << result.depth
+                  << ",\"move\":" << result.move
+                  << ",\"score\":" << result.score
+                  << ",\"nodes\":" << stats.nodes
+                  << ",\"seconds\":" << seconds
+                  << ",\"nps\":" << static_cast<long long>(seconds > 0 ? stats.nodes / seconds : 0)
+                  << ",\"max_depth\":" << stats.maxDepth
+                  << ",\"leaf_evaluations\":" << stats.leafEvaluations
+                  << ",\"cutoffs\":" << stats.cutoffs
+                  << ",\"tt_probes\":" << stats.ttProbes
+                  << ",\"tt_hits\":" << stats.ttHits
+                  << ",\"tt_hit_rate\":" << (stats.ttProbes > 0 ? static_cast<double>(stats.ttHits) / stats.ttProbes : 0)
+                  << ",\"pv\":\"" << line.str() << "\""
+                  << "}\n";
+    }
+}
+
+/**
+ * @brief Runs every suite.
+ *
+ * @param argc The number of command-line arguments.
+ * @param argv The command-line arguments: the table size, the number of threads and the algorithm, all optional.
+ * @return int Exit status of the program.
+ */
+int main(const int argc, char* argv[])
+{
+    const std::size_t ttSizeMb = argc > 1 ? std::stoul(argv[1]) : DEFAULT_TT_SIZE_MB;
+    const int threads = argc > 2 ? std::stoi(argv[2]) : 1;
+    const bool plain = argc > 3 && std::string(argv[3]) == "alphabeta";
+
+    for (const BenchCase &benchCase : TIC_TAC_TOE_SUITE) runCase<TicTacToe>("tictactoe", benchCase, ttSizeMb, threads, plain);
+    for (const BenchCase &benchCase : CONNECT4_SUITE) runCase<Connect4>("connect4", benchCase, ttSizeMb, threads, plain);
+    for (const BenchCase &benchCase : STICKS_SUITE) runCase<SticksGame>("sticks", benchCase, ttSizeMb, threads, plain);
+    return 0;
+}
@@ -0,0 +1,974 @@
+/**
+ * @file AlphaBeta.h
+ * @brief Declaration and implementation of the alpha-beta search engine.
+ */
+
+#ifndef ALPHABETA_H
+#define ALPHABETA_H
+
+#include <Arena.h>
+#include <Game.h>
+#include <MoveOrderer.h>
+#include <OpeningBook.h>
+#include <SearchStats.h>
+#include <SearchTraits.h>
+#include <ThreadPool.h>
+#include <TranspositionTable.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <limits>
+#include <memory>
+#include <vector>
+
+/**
+ * @class AlphaBeta
+ * @brief MinMax search with alpha-beta pruning.
+ *
+ * The engine explores the same tree as the plain MinMax recursion, but skips every branch that
+ * cannot change the result. It works with any `Game` through the `makeMove`/`undoMove` interface.
+ *
+ * The engine is instantiated per concrete game. Since the game classes are `final`, the calls to
+ * the game are resolved at compile time and inlined, and the search parameters come from
+ * `SearchTraits<TGame>` instead of being discovered at runtime.
+ *
+ * The search deepens iteratively: each iteration searches one ply deeper than the previous one,
+ * starting with the best move found so far, until the time budget runs out, the depth limit is
+ * reached or the tree is searched until the end. The move of the deepest completed iteration is
+ * played.
+ *
+ * Results are cached in a transposition table keyed by the Zobrist hash of the game, so a position
+ * reached through different move orders is searched only once. The table is kept between searches.
+ * With `SearchLimits::symmetries`, the key is the canonical hash, shared by the images of the
+ * position by the symmetries of the board, and the root moves leading to symmetric positions are
+ * searched only once.
+ *
+ * With several threads, the work is shared according to `SearchLimits::parallelMode`:
+ * - RootSplit: the root moves of each iteration are dealt round-robin to helper engines, each
+ *   searching its own clone of the game with its own transposition table. The moves are dealt the
+ *   same way every time and the scores are combined in move order, so a search limited by depth
+ *   returns the same move whatever the scheduling of the threads.
+ * - LazySmp: helper engines run their own iterative deepening on clones of the game, sharing the
+ *   lock-free transposition table of the main engine. Half of them search one ply deeper and each
+ *   starts with a different root move, so they fill the table with results the main search soon
+ *   needs. Only the main search decides the move; the helpers stop when it completes.
+ *
+ * An opening book can be attached to the engine: a position found in the book is answered with its
+ * move without searching.
+ *
+ * The moves of each node are sorted by the orderer before being searched, so that the refutation
+ * of the position is likely to come first and the remaining moves are pruned.
+ *
+ * With principal variation search, only the first move of a node gets the full window; the others
+ * are expected to be worse and are only proven so with a null window, then searched again in the
+ * rare case they are better. With aspiration windows, each iteration starts with a window of
+ * `SearchTraits<TGame>::aspirationWindow` around the previous score, widened when the score falls
+ * outside. The line of best play of each iteration is kept in a triangular table.
+ * @tparam TGame The concrete game type.
+ * @tparam TOrderer The move ordering strategy, see `MoveOrderer`.
+ */
+template <typename TGame, typename TOrderer = MoveOrderer<TGame>>
+class AlphaBeta {
+    static_assert(PlayableGame<TGame>, "A game must provide the methods of a PlayableGame.");
+
+private:
+    using Traits = SearchTraits<TGame>; ///< The search parameters of the game.
+    using Clock = std::chrono::steady_clock; ///< The clock measuring the time budget.
+
+    static constexpr long long TIME_CHECK_INTERVAL = 1024; ///< The number of nodes between two clock reads.
+    static constexpr int MAX_PV_LENGTH = 64; ///< The longest principal variation kept, in plies.
+
+    long long nodeCount = 0; ///< The number of nodes visited during the last search.
+    SearchStats stats; ///< The counters of the last search, collected when SEARCH_STATS_ENABLED is true.
+    std::vector<RootMoveScore> iterationRootScores; ///< The root scores of the current iteration.
+    int depthLimit = 0; ///< The depth limit of the current iteration.
+    int completedDepth = -1; ///< The depth of the deepest iteration completed by the last search.
+    int completedScore = 0; ///< The score of the best move of the deepest completed iteration.
+    bool horizonReached = false; ///< Whether the current subtree was cut by the depth limit.
+    bool timeLimited = false; ///< Whether the current iteration may be interrupted by the deadline.
+    bool aborted = false; ///< Whether the current iteration ran out of time or was stopped.
+    Clock::time_point deadline; ///< The time at which the current search must stop.
+    const std::atomic<bool>* stopSignal = nullptr; ///< When set and raised, the current search stops.
+    std::size_t ttSizeMb; ///< The size of the transposition table, in MiB, also used by the root-split helpers.
+    std::shared_ptr<TranspositionTable> transpositionTable; ///< Cache of the positions already searched.
+    std::vector<std::unique_ptr<AlphaBeta>> rootHelpers; ///< The engines searching root moves, each with its own table.
+    std::vector<std::unique_ptr<AlphaBeta>> smpHelpers; ///< The engines searching the whole tree with the shared table.
+    std::unique_ptr<ThreadPool> pool; ///< The threads running the helpers.
+    Arena scratch; ///< The copies of the game and move lists of the helpers, freed when the next search starts.
+    std::vector<TGame*> rootCopies; ///< The copies of the game searched by the root-split helpers.
+    std::atomic<bool> helpersStop{false}; ///< Raised to stop the Lazy SMP helpers.
+    TOrderer orderer; ///< Sorts the moves of each node, learning from the cutoffs of the search.
+    const OpeningBook* openingBook = nullptr; ///< The precomputed moves checked before searching, if any.
+    std::function<void(int depth, int move, int score)> iterationListener; ///< Told the result of every completed iteration.
+    bool principalVariationSearch = true; ///< Whether the moves after the first are searched with a null window first.
+    bool symmetries = true; ///< Whether the table is keyed by the canonical hash of the positions.
+    int pvTable[MAX_PV_LENGTH][MAX_PV_LENGTH] = {}; ///< Row `ply` holds the best line found from that ply, from index `ply`.
+    int pvLength[MAX_PV_LENGTH] = {}; ///< The end of the line in each row of the table.
+    std::vector<int> principalVariation; ///< The line of best play of the deepest completed iteration.
+
+    /**
+     * @brief Alpha-beta search to calculate the score of the current game state.
+     *
+     * @param game Reference to the current game object.
+     * @param depth The current depth of the recursive search.
+     * @param alpha The score the maximizing player is already assured of.
+     * @param beta The score the minimizing player is already assured of.
+     * @param isMaximizing Boolean flag to indicate whether the current player is maximizing or minimizing the score.
+     * @return The score of the state, exact when it lies strictly between alpha and beta, a bound otherwise.
+     */
+    int search(TGame &game, int depth, int alpha, int beta, bool isMaximizing);
+
+    /**
+     * @brief Searches a move that is not the first of its node.
+     *
+     * With principal variation search, the move is first searched with a null window, which only
+     * tells whether it is better than the best move so far, and searched again when it is.
+     * @param game Reference to the game object, after the move.
+     * @param depth The depth of the node after the move.
+     * @param alpha The score the maximizing player is already assured of.
+     * @param beta The score the minimizing player is already assured of.
+     * @param isMaximizing Whether the player to move after the move is maximizing the score.
+     * @return The score of the move, as search() returns it.
+     */
+    int searchLaterMove(TGame &game, int depth, int alpha, int beta, bool isMaximizing);
+
+    /**
+     * @brief Makes a move the start of the principal variation of a ply, followed by the line of the next ply.
+     * @param ply The ply of the move, 0 being the root move.
+     * @param move The move.
+     */
+    void updatePrincipalVariation(int ply, int move);
+
+    /**
+     * @brief Searches every root move to the depth limit of the current iteration.
+     *
+     * @param game Reference to the current game object.
+     * @param moves The root moves, in the order they are searched.
+     * @param alpha The lower bound of the root window.
+     * @param beta The upper bound of the root window.
+     * @param bestScore Receives the score of the best move, a bound if it falls outside the window.
+     * @return The best move. Ties are broken in favor of the first move searched.
+     */
+    int searchRoot(TGame &game, const MoveList &moves, int alpha, int beta, int &bestScore);
+
+    /**
+     * @brief Searches every root move to the depth limit of the current iteration, on several threads.
+     *
+     * @param game Reference to the current game object.
+     * @param moves The root moves, the first ones having the highest priority.
+     * @param threads The number of threads to use, including the calling one.
+     * @param bestScore Receives the score of the best move.
+     * @return The best move. Ties are broken in favor of the first move in the list.
+     */
+    int searchRootParallel(TGame &game, const MoveList &moves, int threads, int &bestScore);
+
+    /**
+     * @brief Calculates the score of a root move with a full window.
+     *
+     * @param game Reference to the game object, in the root state.
+     * @param move The root move to score.
+     * @param isMaximizing Whether the player making the move is maximizing the score.
+     * @return The exact score of the move.
+     */
+    int scoreMove(TGame &game, int move, bool isMaximizing);
+
+    /**
+     * @brief Runs the iterative deepening loop.
+     *
+     * @param game Reference to the current game object.
+     * @param moves The root moves. They are reordered to search the best move first.
+     * @param limits The depth, time and thread limits of the search.
+     * @param firstDepth The depth of the first iteration.
+     * @return The move of the deepest completed iteration.
+     */
+    int iterate(TGame &game, MoveList &moves, const SearchLimits &limits, int firstDepth);
+
+    /**
+     * @brief Runs the iterative deepening loop with Lazy SMP helpers on the other threads.
+     *
+     * @param game Reference to the current game object.
+     * @param moves The root moves.
+     * @param limits The depth, time and thread limits of the search.
+     * @return The move of the deepest iteration completed by the main search.
+     */
+    int iterateLazySmp(TGame &game, MoveList &moves, const SearchLimits &limits);
+
+    /**
+     * @brief Makes sure that enough helper engines and threads exist.
+     * @param helpers The helpers to extend.
+     * @param count The number of helpers needed.
+     * @param shareTable Whether new helpers use the table of this engine instead of their own.
+     */
+    void ensureHelpers(std::vector<std::unique_ptr<AlphaBeta>> &helpers, int count, bool shareTable);
+
+    /**
+     * @brief Resets the per-search state before a search.
+     * @param limits The limits of the search.
+     */
+    void startSearch(const SearchLimits &limits);
+
+    /**
+     * @brief Removes the root moves leading to a position symmetric to the one of an earlier move.
+     * @param game Reference to the current game object.
+     * @param moves The root moves, of which the first of each symmetric group is kept.
+     */
+    static void pruneSymmetricMoves(TGame &game, MoveList &moves);
+
+public:
+    /**
+     * @brief Constructs an alpha-beta engine.
+     * @param ttSizeMb The size of the transposition table, in MiB.
+     */
+    explicit AlphaBeta(std::size_t ttSizeMb = DEFAULT_TT_SIZE_MB);
+
+    /**
+     * @brief Constructs an alpha-beta engine sharing an existing transposition table.
+     * @param table The table to use. It may be shared with engines running on other threads.
+     */
+    explicit AlphaBeta(std::shared_ptr<TranspositionTable> table);
+
+    /**
+     * @brief Attaches an opening book, checked before every search.
+     * @param book The book, which must outlive the engine, or nullptr to always search.
+     */
+    void setOpeningBook(const OpeningBook* book);
+
+    /**
+     * @brief Sets a flag that stops the searches of the engine when raised.
+     *
+     * A stopped search returns the move of its deepest completed iteration, or its first root move
+     * if no iteration completed.
+     * @param signal The flag, which must outlive the searches, or nullptr to never stop early.
+     */
+    void setStopSignal(const std::atomic<bool>* signal);
+
+    /**
+     * @brief Sets a function called each time an iteration of the search completes.
+     *
+     * It is called on the thread running the search, with the depth, best move and score of the iteration.
+     * @param listener The function, or an empty function to stop listening.
+     */
+    void setIterationListener(std::function<void(int depth, int move, int score)> listener);
+
+    /**
+     * @brief Forgets the positions searched so far, before searching an unrelated game.
+     *
+     * The transposition tables of the engine and of its helpers are cleared, and the move ordering
+     * history is reset. Must not be called during a search.
+     */
+    void clear();
+
+    /**
+     * @brief Determines the best move for the player to move.
+     *
+     * The AI maximizes the evaluation and the player minimizes it.
+     * A position found in the opening book is answered without searching.
+     * The first iteration always completes, so a move is returned even with a tiny time budget.
+     * @param game Reference to the current game object.
+     * @param limits The depth, time and thread limits of the search.
+     * @return The best move, or -1 if there is no move available.
+     */
+    [[nodiscard]] int getBestMove(TGame &game, const SearchLimits &limits = SearchLimits::defaults<TGame>());
+
+    /**
+     * @brief Determines the best move for the player to move, with its score and the work it took.
+     *
+     * Same search as getBestMove().
+     * @param game Reference to the current game object.
+     * @param limits The depth, time and thread limits of the search.
+     * @return The best move, its score, the completed depth and the statistics of the search.
+     */
+    [[nodiscard]] SearchResult findBestMove(TGame &game, const SearchLimits &limits = SearchLimits::defaults<TGame>());
+
+    /**
+     * @brief Gets the number of nodes visited during the last search, by all threads.
+     * @return The node count of the last call to getBestMove().
+     */
+    [[nodiscard]] long long getNodeCount() const;
+
+
+    /**
+     * @brief Gets the depth of the deepest iteration completed by the last search.
+     * @return The depth below the root move, or -1 if no iteration was run.
+     */
+    [[nodiscard]] int getCompletedDepth() const;
+
+    /**
+     * @brief Gets the score of the move returned by the last search.
+     * @return The score of the deepest completed iteration, or the book score of a book move.
+     */
+    [[nodiscard]] int getBestScore() const;
+
+    /**
+     * @brief Gets the line of best play found by the last search.
+     * @return The moves expected from both players, starting with the best move, at most MAX_PV_LENGTH of them.
+     */
+    [[nodiscard]] const std::vector<int> &getPrincipalVariation() const;
+};
+
+/**
+ * @brief Constructs an alpha-beta engine.
+ * @param ttSizeMb The size of the transposition table, in MiB.
+ */
+template <typename TGame, typename TOrderer>
+AlphaBeta<TGame, TOrderer>::AlphaBeta(const std::size_t ttSizeMb)
+    : ttSizeMb(ttSizeMb), transpositionTable(std::make_shared<TranspositionTable>(ttSizeMb)) {}
+
+/**
+ * @brief Constructs an alpha-beta engine sharing an existing transposition table.
+ * @param table The table to use. It may be shared with engines running on other threads.
+ */
+template <typename TGame, typename TOrderer>
+AlphaBeta<TGame, TOrderer>::AlphaBeta(std::shared_ptr<TranspositionTable> table)
+    : ttSizeMb(DEFAULT_TT_SIZE_MB), transpositionTable(std::move(table)) {}
+
+/**
+ * @brief Alpha-beta search to calculate the score of the current game state.
+ *
+ * @param game Reference to the current game object.
+ * @param depth The current depth of the recursive search.
+ * @param alpha The score the maximizing player is already assured of.
+ * @param beta The score the minimizing player is already assured of.
+ * @param isMaximizing Boolean flag to indicate whether the current player is maximizing or minimizing the score.
+ * @return The score of the state, exact when it lies strictly between alpha and beta, a bound otherwise.
+ */
+template <typename TGame, typename TOrderer>
+int AlphaBeta<TGame, TOrderer>::search(TGame &game, const int depth, int alpha, int beta, const bool isMaximizing)
+{
+    if (++nodeCount % TIME_CHECK_INTERVAL == 0
+        && ((timeLimited && Clock::now() >= deadline) || (stopSignal && stopSignal->load(std::memory_order_relaxed))))
+    {
+        aborted = true;
+    }
+    if (aborted) return 0; // The iteration is discarded, the score does not matter.
+
+    if constexpr (SEARCH_STATS_ENABLED) stats.maxDepth = std::max(stats.maxDepth, depth);
+    const int ply = depth + 1;
+    if (ply < MAX_PV_LENGTH) pvLength[ply] = ply; // No line is known until a move improves the window.
+
+    if (game.isTerminal())
+    {
+        if constexpr (SEARCH_STATS_ENABLED) ++stats.leafEvaluations;
+        return game.evaluate(); // Return the evaluation of the current state.
+    }
+    if (depth >= depthLimit)
+    {
+        if constexpr (SEARCH_STATS_ENABLED) ++stats.leafEvaluations;
+        horizonReached = true; // A deeper iteration could find a different score.
+        return game.evaluate();
+    }
+
+    const uint64_t key = symmetries ? game.getCanonicalHash() : game.getHash();
+    const int remainingDepth = depthLimit - depth;
+    int ttMove = -1;
+    if constexpr (SEARCH_STATS_ENABLED) ++stats.ttProbes;
+    if (TTEntry entry; transpositionTable->probe(key, entry))
+    {
+        if constexpr (SEARCH_STATS_ENABLED) ++stats.ttHits;
+        // Even an entry too shallow to be reused knows which move was best.
+        ttMove = symmetries && entry.move >= 0 ? game.fromCanonicalMove(entry.move) : entry.move;
+        if (entry.depth >= std::min(remainingDepth, TTEntry::MAX_DEPTH))
+        {
+            // The position was already searched at least as deep: its score or bounds can be reused.
+            if (entry.bound == Bound::Lower) alpha = std::max(alpha, static_cast<int>(entry.score));
+            else if (entry.bound == Bound::Upper) beta = std::min(beta, static_cast<int>(entry.score));
+            if (entry.bound == Bound::Exact || alpha >= beta)
+            {
+                // Only an entry searched until the end of the game is final.
+                if (entry.depth < TTEntry::MAX_DEPTH) horizonReached = true;
+                return entry.score;
+            }
+        }
+    }
+
+    int bestScore = isMaximizing ? std::numeric_limits<int>::min() : std::numeric_limits<int>::max();
+    int bestMove = -1;
+    const int searchedAlpha = alpha;
+    const int searchedBeta = beta;
+    const bool outerHorizonReached = horizonReached;
+    horizonReached = false;
+
+    MoveList moves;
+    game.generateMoves(moves);
+    orderer.order(moves, depth + 1, ttMove, isMaximizing);
+    for (int i = 0; i < moves.size(); ++i)
+    {
+        const int move = moves[i];
+        game.makeMove(move);
+        const int score = i == 0 ? search(game, depth + 1, alpha, beta, !isMaximizing)
+                                 : searchLaterMove(game, depth + 1, alpha, beta, !isMaximizing);
+        game.undoMove(move);
+        if (aborted) return 0;
+
+        if (isMaximizing ? score > bestScore : score < bestScore)
+        {
+            bestScore = score;
+            bestMove = move;
+        }
+        if (score > alpha && score < beta) updatePrincipalVariation(ply, move);
+        if (isMaximizing) alpha = std::max(alpha, bestScore);
+        else beta = std::min(beta, bestScore);
+
+        // The opponent will never let the game reach this state: the remaining moves are irrelevant.
+        if (alpha >= beta)
+        {
+            if constexpr (SEARCH_STATS_ENABLED) ++stats.cutoffs;
+            orderer.recordCutoff(move, depth + 1, remainingDepth, isMaximizing);
+            break;
+        }
+    }
+
+    // A score outside the window only bounds the real score from the side the search was cut off.
+    const Bound bound = bestScore <= searchedAlpha ? Bound::Upper
+                      : bestScore >= searchedBeta ? Bound::Lower
+                      : Bound::Exact;
+    // A subtree searched until the end of the game gives the same result at any depth.
+    const int storedMove = symmetries && bestMove >= 0 ? game.toCanonicalMove(bestMove) : bestMove;
+    transpositionTable->store(key, horizonReached ? remainingDepth : TTEntry::MAX_DEPTH, bound, bestScore, storedMove);
+    horizonReached = horizonReached || outerHorizonReached;
+
+    return bestScore;
+}
+
+/**
+ * @brief Searches a move that is not the first of its node.
+ *
+ * With principal variation search, the move is first searched with a null window, which only
+ * tells whether it is better than the best move so far, and searched again when it is.
+ * @param game Reference to the game object, after the move.
+ * @param depth The depth of the node after the move.
+ * @param alpha The score the maximizing player is already assured of.
+ * @param beta The score the minimizing player is already assured of.
+ * @param isMaximizing Whether the player to move after the move is maximizing the score.
+ * @return The score of the move, as search() returns it.
+ */
+template <typename TGame, typename TOrderer>
+int AlphaBeta<TGame, TOrderer>::searchLaterMove(TGame &game, const int depth, const int alpha, const int beta,
+                                                const bool isMaximizing)
+{
+    if (!principalVariationSearch || beta - alpha <= 1) return search(game, depth, alpha, beta, isMaximizing);
+
+    // The player who made the move is maximizing when the next one is not.
+    const int score = isMaximizing ? search(game, depth, beta - 1, beta, true)
+                                   : search(game, depth, alpha, alpha + 1, false);
+    if (aborted || score <= alpha || score >= beta) return score;
+    return search(game, depth, alpha, beta, isMaximizing);
+}
+
+/**
+ * @brief Makes a move the start of the principal variation of a ply, followed by the line of the next ply.
+ * @param ply The ply of the move, 0 being the root move.
+ * @param move The move.
+ */
+template <typename TGame, typename TOrderer>
+void AlphaBeta<TGame, TOrderer>::updatePrincipalVariation(const int ply, const int move)
+{
+    if (ply >= MAX_PV_LENGTH) return;
+
+    pvTable[ply][ply] = move;
+    const int end = ply + 1 < MAX_PV_LENGTH ? pvLength[ply + 1] : ply + 1;
+    for (int i = ply + 1; i < end; ++i)
+    {
+        pvTable[ply][i] = pvTable[ply + 1][i];
+    }
+    pvLength[ply] = std::max(end, ply + 1);
+}
+
+/**
+ * @brief Searches every root move to the depth limit of the current iteration.
+ *
+ * @param game Reference to the current game object.
+ * @param moves The root moves, in the order they are searched.
+ * @param alpha The lower bound of the root window.
+ * @param beta The upper bound of the root window.
+ * @param bestScore Receives the score of the best move, a bound if it falls outside the window.
+ * @return The best move. Ties are broken in favor of the first move searched.
+ */
+template <typename TGame, typename TOrderer>
+int AlphaBeta<TGame, TOrderer>::searchRoot(TGame &game, const MoveList &moves, const int alpha, const int beta, int &bestScore)
+{
+    const bool isMaximizing = game.getCurrentPlayer() == game.AI;
+    bestScore = isMaximizing ? std::numeric_limits<int>::min() : std::numeric_limits<int>::max();
+    int bestMove = -1;
+    iterationRootScores.clear();
+    pvLength[0] = 0;
+
+    for (int i = 0; i < moves.size(); ++i)
+    {
+        const int move = moves[i];
+        game.makeMove(move);
+
+        // Only a strictly better score can change the best move, so the window starts at bestScore.
+        // No score lies outside the bounds of the game, which lets the search stop as soon as it finds a win.
+        const int moveAlpha = isMaximizing ? std::max(bestScore, alpha) : alpha;
+        const int moveBeta = isMaximizing ? beta : std::min(bestScore, beta);
+        const int score = i == 0 ? search(game, 0, moveAlpha, moveBeta, !isMaximizing)
+                                 : searchLaterMove(game, 0, moveAlpha, moveBeta, !isMaximizing);
+        game.undoMove(move);
+        if (aborted) break;
+        if constexpr (SEARCH_STATS_ENABLED) iterationRootScores.push_back({move, score});
+
+        if (isMaximizing ? score > bestScore : score < bestScore)
+        {
+            bestScore = score;
+            bestMove = move;
+            updatePrincipalVariation(0, move);
+        }
+
+        // Nothing can beat a won game, and a score beyond the window must be searched again with a wider one.
+        if (bestScore == (isMaximizing ? Traits::maxScore : Traits::minScore)) break;
+        if (isMaximizing ? bestScore >= beta : bestScore <= alpha) break;
+    }
+
+    return bestMove;
+}
+
+/**
+ * @brief Searches every root move to the depth limit of the current iteration, on several threads.
+ *
+ * @param game Reference to the current game object.
+ * @param moves The root moves, the first ones having the highest priority.
+ * @param threads The number of threads to use, including the calling one.
+ * @param bestScore Receives the score of the best move.
+ * @return The best move. Ties are broken in favor of the first move in the list.
+ */
+template <typename TGame, typename TOrderer>
+int AlphaBeta<TGame, TOrderer>::searchRootParallel(TGame &game, const MoveList &moves, const int threads, int &bestScore)
+{
+    const bool isMaximizing = game.getCurrentPlayer() == game.AI;
+    const int workerCount = std::min(threads, moves.size());
+    ensureHelpers(rootHelpers, workerCount - 1, false);
+
+    // Clone on the first iteration, before any thread starts making moves on the original. The
+    // copies are back at the root after each iteration, so the next ones reuse them.
+    while (static_cast<int>(rootCopies.size()) < workerCount - 1)
+    {
+        rootCopies.push_back(scratch.create<TGame>(game));
+    }
+
+    std::vector<int> scores(moves.size());
+    std::vector<std::vector<int>> lines(moves.size()); // The principal variation after each root move.
+    const auto searchShare = [&](AlphaBeta &engine, TGame &copy, const int first)
+    {
+        for (int i = first; i < moves.size() && !engine.aborted; i += workerCount)
+        {
+            scores[i] = engine.scoreMove(copy, moves[i], isMaximizing);
+            lines[i].assign(engine.pvTable[1] + 1, engine.pvTable[1] + engine.pvLength[1]);
+        }
+    };
+
+    std::vector<std::future<void>> shares;
+    for (int worker = 1; worker < workerCount; ++worker)
+    {
+        AlphaBeta &helper = *rootHelpers[worker - 1];
+        helper.nodeCount = 0;
+        helper.stats = SearchStats();
+        helper.depthLimit = depthLimit;
+        helper.horizonReached = false;
+        helper.timeLimited = timeLimited;
+        helper.aborted = false;
+        helper.deadline = deadline;
+        helper.stopSignal = stopSignal;
+        helper.principalVariationSearch = principalVariationSearch;
+        helper.symmetries = symmetries;
+        shares.push_back(pool->submit([&, worker] { searchShare(helper, *rootCopies[worker - 1], worker); }));
+    }
+    searchShare(*this, game, 0);
+
+    for (int worker = 1; worker < workerCount; ++worker)
+    {
+        shares[worker - 1].get();
+        const AlphaBeta &helper = *rootHelpers[worker - 1];
+        nodeCount += helper.nodeCount;
+        stats.merge(helper.stats);
+        horizonReached = horizonReached || helper.horizonReached;
+        aborted = aborted || helper.aborted;
+    }
+    if (aborted) return -1;
+
+    bestScore = isMaximizing ? std::numeric_limits<int>::min() : std::numeric_limits<int>::max();
+    int bestMove = -1;
+    iterationRootScores.clear();
+    for (int i = 0; i < moves.size(); ++i)
+    {
+        if constexpr (SEARCH_STATS_ENABLED) iterationRootScores.push_back({moves[i], scores[i]});
+        if (isMaximizing ? scores[i] > bestScore : scores[i] < bestScore)
+        {
+            bestScore = scores[i];
+            bestMove = moves[i];
+            pvTable[0][0] = bestMove;
+            std::copy(lines[i].begin(), lines[i].end(), pvTable[0] + 1);
+            pvLength[0] = 1 + static_cast<int>(lines[i].size());
+        }
+    }
+    return bestMove;
+}
+
+/**
+ * @brief Calculates the score of a root move with a full window.
+ *
+ * @param game Reference to the game object, in the root state.
+ * @param move The root move to score.
+ * @param isMaximizing Whether the player making the move is maximizing the score.
+ * @return The exact score of the move.
+ */
+template <typename TGame, typename TOrderer>
+int AlphaBeta<TGame, TOrderer>::scoreMove(TGame &game, const int move, const bool isMaximizing)
+{
+    game.makeMove(move);
+    const int score = search(game, 0, Traits::minScore, Traits::maxScore, !isMaximizing);
+    game.undoMove(move);
+    return score;
+}
+
+/**
+ * @brief Runs the iterative deepening loop.
+ *
+ * @param game Reference to the current game object.
+ * @param moves The root moves. They are reordered to search the best move first.
+ * @param limits The depth, time and thread limits of the search.
+ * @param firstDepth The depth of the first iteration.
+ * @return The move of the deepest completed iteration.
+ */
+template <typename TGame, typename TOrderer>
+int AlphaBeta<TGame, TOrderer>::iterate(TGame &game, MoveList &moves, const SearchLimits &limits, const int firstDepth)
+{
+    const bool rootSplit = limits.threads > 1 && limits.parallelMode == ParallelMode::RootSplit;
+
+    int bestMove = moves[0];
+    for (int depth = firstDepth; depth <= limits.maxDepth; ++depth)
+    {
+        depthLimit = depth;
+
+        // The previous score is a good guess: a narrow window around it prunes more.
+        // The root-split search always uses the full window, so that its result does not depend on the previous one.
+        int window = !rootSplit && limits.aspirationWindows && completedDepth >= 0 ? Traits::aspirationWindow : 0;
+        int alpha = window > 0 ? std::max(Traits::minScore, completedScore - window) : Traits::minScore;
+        int beta = window > 0 ? std::min(Traits::maxScore, completedScore + window) : Traits::maxScore;
+
+        int score;
+        int move;
+        while (true)
+        {
+            horizonReached = false;
+            move = rootSplit ? searchRootParallel(game, moves, limits.threads, score)
+                             : searchRoot(game, moves, alpha, beta, score);
+            if (aborted) break;
+
+            // Outside the window, the score is only a bound: search again with a wider window on that side.
+            window *= 4;
+            if (score <= alpha && alpha > Traits::minScore) alpha = std::max(Traits::minScore, score - window);
+            else if (score >= beta && beta < Traits::maxScore) beta = std::min(Traits::maxScore, score + window);
+            else break;
+        }
+        if (aborted) break; // The interrupted iteration is discarded.
+
+        bestMove = move;
+        completedDepth = depth;
+        completedScore = score;
+        principalVariation.assign(pvTable[0], pvTable[0] + pvLength[0]);
+        if constexpr (SEARCH_STATS_ENABLED) stats.rootScores = iterationRootScores;
+        if (iterationListener) iterationListener(depth, bestMove, score);
+        timeLimited = limits.timeBudget.count() > 0;
+
+        // Search the best move first in the next iteration: the other moves then only need to be refuted.
+        const auto best = std::find(moves.begin(), moves.end(), bestMove);
+        std::rotate(moves.begin(), best, best + 1);
+
+        // Nothing changes in deeper iterations once the whole tree was searched or the result is decided.
+        if (!horizonReached || score == Traits::maxScore || score == Traits::minScore) break;
+    }
+
+    return bestMove;
+}
+
+/**
+ * @brief Runs the iterative deepening loop with Lazy SMP helpers on the other threads.
+ *
+ * @param game Reference to the current game object.
+ * @param moves The root moves.
+ * @param limits The depth, time and thread limits of the search.
+ * @return The move of the deepest iteration completed by the main search.
+ */
+template <typename TGame, typename TOrderer>
+int AlphaBeta<TGame, TOrderer>::iterateLazySmp(TGame &game, MoveList &moves, const SearchLimits &limits)
+{
+    const int helperCount = limits.threads - 1;
+    ensureHelpers(smpHelpers, helperCount, true);
+    helpersStop.store(false, std::memory_order_relaxed);
+
+    SearchLimits helperLimits = limits;
+    helperLimits.threads = 1;
+
+    std::vector<TGame*> copies;
+    MoveList* helperMoves = scratch.createArray<MoveList>(helperCount);
+    std::vector<std::future<void>> helpers;
+    for (int i = 0; i < helperCount; ++i)
+    {
+        copies.push_back(scratch.create<TGame>(game));
+        helperMoves[i] = moves;
+
+        // Each helper starts with a different root move, so that the threads diverge.
+        MoveList &order = helperMoves[i];
+        std::rotate(order.begin(), order.begin() + (i + 1) % order.size(), order.end());
+
+        AlphaBeta &helper = *smpHelpers[i];
+        helper.startSearch(helperLimits);
+        helper.stopSignal = &helpersStop;
+        helper.timeLimited = limits.timeBudget.count() > 0; // Helpers have no first iteration to complete.
+        helpers.push_back(pool->submit([&, i]
+        {
+            // Odd helpers start one iteration deeper so that the threads diverge.
+            (void) smpHelpers[i]->iterate(*copies[i], helperMoves[i], helperLimits, i % 2);
+        }));
+    }
+
+    const int bestMove = iterate(game, moves, helperLimits, 0);
+
+    helpersStop.store(true, std::memory_order_relaxed);
+    for (int i = 0; i < helperCount; ++i)
+    {
+        helpers[i].get();
+        nodeCount += smpHelpers[i]->nodeCount;
+        stats.merge(smpHelpers[i]->stats);
+    }
+    return bestMove;
+}
+
+/**
+ * @brief Makes sure that enough helper engines and threads exist.
+ * @param helpers The helpers to extend.
+ * @param count The number of helpers needed.
+ * @param shareTable Whether new helpers use the table of this engine instead of their own.
+ */
+template <typename TGame, typename TOrderer>
+void AlphaBeta<TGame, TOrderer>::ensureHelpers(std::vector<std::unique_ptr<AlphaBeta>> &helpers, const int count, const bool shareTable)
+{
+    while (static_cast<int>(helpers.size()) < count)
+    {
+        helpers.push_back(shareTable ? std::make_unique<AlphaBeta>(transpositionTable)
+                                     : std::make_unique<AlphaBeta>(ttSizeMb));
+    }
+    if (count > 0 && (!pool || static_cast<int>(pool->size()) < count))
+    {
+        pool = std::make_unique<ThreadPool>(count);
+    }
+}
+
+/**
+ * @brief Resets the per-search state before a search.
+ * @param limits The limits of the search.
+ */
+template <typename TGame, typename TOrderer>
+void AlphaBeta<TGame, TOrderer>::startSearch(const SearchLimits &limits)
+{
+    nodeCount = 0;
+    stats = SearchStats();
+    completedDepth = -1;
+    completedScore = 0;
+    aborted = false;
+    timeLimited = false;
+    deadline = Clock::now() + limits.timeBudget;
+    principalVariationSearch = limits.principalVariationSearch;
+    symmetries = limits.symmetries;
+    principalVariation.clear();
+    rootCopies.clear();
+    scratch.reset();
+    orderer.startSearch();
+}
+
+/**
+ * @brief Removes the root moves leading to a position symmetric to the one of an earlier move.
+ *
+ * Symmetric positions have the same score, so only one of them needs to be searched. On an empty
+ * Connect 4 board, the three columns left of the center mirror the three on its right.
+ * @param game Reference to the current game object.
+ * @param moves The root moves, of which the first of each symmetric group is kept.
+ */
+template <typename TGame, typename TOrderer>
+void AlphaBeta<TGame, TOrderer>::pruneSymmetricMoves(TGame &game, MoveList &moves)
+{
+    uint64_t keys[MAX_MOVES];
+    MoveList kept;
+    for (const int move : moves)
+    {
+        game.makeMove(move);
+        const uint64_t key = game.getCanonicalHash();
+        game.undoMove(move);
+        if (std::find(keys, keys + kept.size(), key) == keys + kept.size())
+        {
+            keys[kept.size()] = key;
+            kept.add(move);
+        }
+    }
+    moves = kept;
+}
+
+/**
+ * @brief Attaches an opening book, checked before every search.
+ * @param book The book, which must outlive the engine, or nullptr to always search.
+ */
+template <typename TGame, typename TOrderer>
+void AlphaBeta<TGame, TOrderer>::setOpeningBook(const OpeningBook* book)
+{
+    openingBook = book;
+}
+
+/**
+ * @brief Sets a flag that stops the searches of the engine when raised.
+ *
+ * A stopped search returns the move of its deepest completed iteration, or its first root move
+ * if no iteration completed.
+ * @param signal The flag, which must outlive the searches, or nullptr to never stop early.
+ */
+template <typename TGame, typename TOrderer>
+void AlphaBeta<TGame, TOrderer>::setStopSignal(const std::atomic<bool>* signal)
+{
+    stopSignal = signal;
+}
+
+/**
+ * @brief Sets a function called each time an iteration of the search completes.
+ *
+ * It is called on the thread running the search, with the depth, best move and score of the iteration.
+ * @param listener The function, or an empty function to stop listening.
+ */
+template <typename TGame, typename TOrderer>
+void AlphaBeta<TGame, TOrderer>::setIterationListener(std::function<void(int depth, int move, int score)> listener)
+{
+    iterationListener = std::move(listener);
+}
+
+/**
+ * @brief Forgets the positions searched so far, before searching an unrelated game.
+ *
+ * The Lazy SMP helpers share the table of the engine; the root-split helpers have their own.
+ */
+template <typename TGame, typename TOrderer>
+void AlphaBeta<TGame, TOrderer>::clear()
+{
+    transpositionTable->clear();
+    orderer = TOrderer();
+    for (auto &helper : smpHelpers) helper->orderer = TOrderer();
+    for (auto &helper : rootHelpers) helper->clear();
+}
+
+/**
+ * @brief Determines the best move for the player to move.
+ *
+ * The AI maximizes the evaluation and the player minimizes it.
+ * A position found in the opening book is answered without searching.
+ * The first iteration always completes, so a move is returned even with a tiny time budget.
+ * @param game Reference to the current game object.
+ * @param limits The depth, time and thread limits of the search.
+ * @return The best move, or -1 if there is no move available.
+ */
+template <typename TGame, typename TOrderer>
+int AlphaBeta<TGame, TOrderer>::getBestMove(TGame &game, const SearchLimits &limits)
+{
+    return findBestMove(game, limits).move;
+}
+
+/**
+ * @brief Determines the best move for the player to move, with its score and the work it took.
+ *
+ * Same search as getBestMove().
+ * @param game Reference to the current game object.
+ * @param limits The depth, time and thread limits of the search.
+ * @return The best move, its score, the completed depth and the statistics of the search.
+ */
+template <typename TGame, typename TOrderer>
+SearchResult AlphaBeta<TGame, TOrderer>::findBestMove(TGame &game, const SearchLimits &limits)
+{
+    const auto start = Clock::now();
+    startSearch(limits);
+
+    SearchResult result;
+    MoveList moves;
+    game.generateMoves(moves);
+    if (moves.empty()) return result;
+
+    // The book is keyed by the canonical positions. It comes from a file: its move is only
+    // trusted if it is the canonical image of a legal move, and never mapped back directly.
+    BookEntry bookEntry;
+    const int* bookMove = moves.end();
+    if (openingBook && openingBook->probe(game.getCanonicalHash(), bookEntry))
+    {
+        bookMove = std::find_if(moves.begin(), moves.end(),
+            [&](const int move) { return game.toCanonicalMove(move) == bookEntry.move; });
+    }
+    if (bookMove != moves.end())
+    {
+        completedScore = bookEntry.score;
+        result.move = *bookMove;
+        principalVariation.assign(1, result.move);
+        result.principalVariation = principalVariation;
+        result.score = bookEntry.score;
+        result.stats.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+        return result;
+    }
+
+    if (symmetries) pruneSymmetricMoves(game, moves);
+
+    // The first iteration has no best move yet: start with the most promising one.
+    TTEntry entry;
+    int ttMove = -1;
+    if (symmetries && transpositionTable->probe(game.getCanonicalHash(), entry)) ttMove = entry.move >= 0 ? game.fromCanonicalMove(entry.move) : -1;
+    else if (!symmetries && transpositionTable->probe(game.getHash(), entry)) ttMove = entry.move;
+    orderer.order(moves, 0, ttMove, game.getCurrentPlayer() == game.AI);
+
+    result.move = limits.threads > 1 && limits.parallelMode == ParallelMode::LazySmp
+        ? iterateLazySmp(game, moves, limits)
+        : iterate(game, moves, limits, 0);
+    result.score = completedScore;
+    result.depth = completedDepth;
+    result.stats = stats;
+    result.stats.nodes = nodeCount;
+    result.stats.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+    result.principalVariation = principalVariation;
+    return result;
+}
+
+/**
+ * @brief Gets the number of nodes visited during the last search, by all threads.
+ * @return The node count of the last call to getBestMove().
+ */
+template <typename TGame, typename TOrderer>
+long long AlphaBeta<TGame, TOrderer>::getNodeCount() const
+{
+    return nodeCount;
+}
+
+/**
+ * @brief Gets the depth of the deepest iteration completed by the last search.
+ * @return The depth below the root move, or -1 if no iteration was run.
+ */
+template <typename TGame, typename TOrderer>
+int AlphaBeta<TGame, TOrderer>::getCompletedDepth() const
+{
+    return completedDepth;
+}
+
+/**
+ * @brief Gets the score of the move returned by the last search.
+ * @return The score of the deepest completed iteration, or the book score of a book move.
+ */
+template <typename TGame, typename TOrderer>
+int AlphaBeta<TGame, TOrderer>::getBestScore() const
+{
+    return completedScore;
+}
+
+/**
+ * @brief Gets the line of best play found by the last search.
+ * @return The moves expected from both players, starting with the best move, at most MAX_PV_LENGTH of them.
+ */
+template <typename TGame, typename TOrderer>
+const std::vector<int> &AlphaBeta<TGame, TOrderer>::getPrincipalVariation() const
+{
+    return principalVariation;
+}
+
+#endif //ALPHABETA_H
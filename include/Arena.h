@@ -0,0 +1,164 @@
+/**
+ * @file Arena.h
+ * @brief Declaration of a bump allocator releasing all its objects at once.
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+constexpr std::size_t DEFAULT_ARENA_BLOCK_SIZE = 1 << 20; ///< The default size of the memory blocks of an arena, in bytes.
+
+/**
+ * @class Arena
+ * @brief Allocates objects contiguously from large blocks, and frees them all with one reset.
+ *
+ * Allocating is a pointer increment in the current block; a new block is taken when it is full.
+ * Nothing is freed individually: `reset()` destroys every object and rewinds to the first block.
+ * The blocks are kept, so an arena reset at the end of each search stops touching the heap once it
+ * has grown to the size of the largest search, and objects allocated together stay next to each other.
+ *
+ * The destructors of the objects that need one are run by `reset()`, in reverse order of creation.
+ * An arena is used by one thread at a time: each search owns its own, so the threads never
+ * contend on an allocator lock.
+ */
+class Arena final {
+private:
+    /**
+     * @struct Block
+     * @brief A chunk of memory the objects are carved from.
+     */
+    struct Block {
+        std::unique_ptr<std::byte[]> memory; ///< The storage of the block.
+        std::size_t size; ///< The size of the block, in bytes.
+    };
+
+    /**
+     * @struct Cleanup
+     * @brief A destructor to run on reset, stored in the arena next to its object.
+     */
+    struct Cleanup {
+        void (*destroy)(void*); ///< Destroys the object.
+        void* object; ///< The object to destroy.
+        Cleanup* next; ///< The cleanup registered before this one.
+    };
+
+    std::size_t blockSize; ///< The size of the blocks, except those holding a larger allocation.
+    std::vector<Block> blocks; ///< The blocks, in the order they are used.
+    std::size_t current = 0; ///< The index of the block being filled.
+    std::size_t offset = 0; ///< The number of bytes used in the current block.
+    std::size_t used = 0; ///< The number of bytes handed out since the last reset, in the previous blocks.
+    Cleanup* cleanups = nullptr; ///< The last registered destructor.
+
+    /**
+     * @brief Moves to the next block large enough for an allocation, creating it if needed.
+     * @param size The size of the allocation, in bytes, including the alignment padding.
+     */
+    void nextBlock(std::size_t size);
+
+public:
+    /**
+     * @brief Constructs an empty arena. No memory is taken until the first allocation.
+     * @param blockSize The size of the blocks, in bytes.
+     */
+    explicit Arena(std::size_t blockSize = DEFAULT_ARENA_BLOCK_SIZE);
+
+    /**
+     * @brief Destroys the objects and releases the blocks.
+     */
+    ~Arena();
+
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    /**
+     * @brief Allocates uninitialized memory.
+     * @param size The number of bytes.
+     * @param alignment The alignment of the memory, a power of two.
+     * @return The memory, valid until the next reset.
+     */
+    [[nodiscard]] void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+
+    /**
+     * @brief Constructs an object in the arena.
+     * @tparam T The type of the object.
+     * @tparam TArgs The types of the constructor arguments.
+     * @param args The constructor arguments.
+     * @return The object, destroyed by the next reset.
+     */
+    template <typename T, typename... TArgs>
+    T* create(TArgs &&... args);
+
+    /**
+     * @brief Constructs contiguous default-initialized objects in the arena.
+     * @tparam T The type of the objects, which must be trivially destructible.
+     * @param count The number of objects.
+     * @return The first object, valid until the next reset.
+     */
+    template <typename T>
+    T* createArray(std::size_t count);
+
+    /**
+     * @brief Destroys every object and makes all the memory available again, without releasing it.
+     */
+    void reset();
+
+    /**
+     * @brief Gets the memory handed out since the last reset.
+     * @return The number of bytes allocated, including the alignment padding.
+     */
+    [[nodiscard]] std::size_t bytesUsed() const;
+
+    /**
+     * @brief Gets the memory held by the arena.
+     * @return The total size of the blocks, in bytes.
+     */
+    [[nodiscard]] std::size_t bytesReserved() const;
+};
+
+/**
+ * @brief Constructs an object in the arena.
+ *
+ * When the type has a destructor to run, a cleanup record is allocated after the object.
+ * @tparam T The type of the object.
+ * @tparam TArgs The types of the constructor arguments.
+ * @param args The constructor arguments.
+ * @return The object, destroyed by the next reset.
+ */
+template <typename T, typename... TArgs>
+T* Arena::create(TArgs &&... args)
+{
+    T* object = new (allocate(sizeof(T), alignof(T))) T(std::forward<TArgs>(args)...);
+    if constexpr (!std::is_trivially_destructible_v<T>)
+    {
+        cleanups = new (allocate(sizeof(Cleanup), alignof(Cleanup)))
+            Cleanup{[](void* pointer) { static_cast<T*>(pointer)->~T(); }, object, cleanups};
+    }
+    return object;
+}
+
+/**
+ * @brief Constructs contiguous default-initialized objects in the arena.
+ * @tparam T The type of the objects, which must be trivially destructible.
+ * @param count The number of objects.
+ * @return The first object, valid until the next reset.
+ */
+template <typename T>
+T* Arena::createArray(const std::size_t count)
+{
+    static_assert(std::is_trivially_destructible_v<T>, "The arena does not destroy the elements of an array");
+    T* objects = static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        new (objects + i) T;
+    }
+    return objects;
+}
+
+#endif //ARENA_H
@@ -0,0 +1,207 @@
+/**
+ * @file AsyncSearch.h
+ * @brief Declaration and implementation of searches running in the background.
+ */
+
+#ifndef ASYNCSEARCH_H
+#define ASYNCSEARCH_H
+
+#include <AlphaBeta.h>
+#include <SearchStats.h>
+#include <SearchTraits.h>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <thread>
+
+/**
+ * @class AsyncSearch
+ * @brief Handle of a search running on a background thread.
+ *
+ * The search works on its own copy of the game, so the caller may keep using the original.
+ * Its progress can be polled, and it can be cancelled at any time: it then returns the move of its
+ * deepest completed iteration. Destroying the handle cancels the search and waits for its thread.
+ *
+ * The engine must outlive the handle and must not be used by anyone else until the search is over.
+ * @tparam TGame The concrete game type.
+ */
+template <typename TGame>
+class AsyncSearch final {
+private:
+    /**
+     * @struct Shared
+     * @brief The state shared with the background thread.
+     */
+    struct Shared {
+        explicit Shared(const TGame &game) : game(game) {}
+
+        TGame game; ///< The copy of the game being searched.
+        std::atomic<bool> stop{false}; ///< Raised to cancel the search.
+        std::atomic<bool> done{false}; ///< Raised when the result is available.
+        std::atomic<int> bestMove{-1}; ///< The move of the deepest completed iteration.
+        std::atomic<int> completedDepth{-1}; ///< The depth of the deepest completed iteration.
+    };
+
+    std::unique_ptr<Shared> shared; ///< The state shared with the background thread.
+    std::shared_future<SearchResult> result; ///< The result of the search.
+    std::thread thread; ///< The thread running the search.
+
+public:
+    /**
+     * @brief Starts a search on a background thread.
+     * @param engine The engine running the search.
+     * @param game The position to search. It is copied.
+     * @param limits The depth, time and thread limits of the search.
+     */
+    AsyncSearch(AlphaBeta<TGame> &engine, const TGame &game, const SearchLimits &limits = SearchLimits::defaults<TGame>());
+
+    AsyncSearch(AsyncSearch &&) noexcept = default;
+    AsyncSearch &operator=(AsyncSearch &&) = delete;
+
+    /**
+     * @brief Cancels the search and waits for its thread.
+     */
+    ~AsyncSearch();
+
+    /**
+     * @brief Checks whether the search is over.
+     * @return true if the result is available, false otherwise.
+     */
+    [[nodiscard]] bool poll() const;
+
+    /**
+     * @brief Gets the best move found so far.
+     * @return The move of the deepest completed iteration, or -1 if none completed yet.
+     */
+    [[nodiscard]] int bestSoFar() const;
+
+    /**
+     * @brief Gets the depth searched so far.
+     * @return The depth of the deepest completed iteration, or -1 if none completed yet.
+     */
+    [[nodiscard]] int completedDepth() const;
+
+    /**
+     * @brief Asks the search to stop as soon as possible. The result becomes available shortly after.
+     */
+    void cancel();
+
+    /**
+     * @brief Gets the future result of the search.
+     * @return A future holding the result once the search is over.
+     */
+    [[nodiscard]] std::shared_future<SearchResult> future() const;
+
+    /**
+     * @brief Waits for the search to end, cancelling it if it lasts longer than a deadline.
+     * @param timeout The time to wait before cancelling the search.
+     * @return The result of the search.
+     */
+    SearchResult waitFor(std::chrono::milliseconds timeout);
+};
+
+/**
+ * @brief Starts a search on a background thread.
+ * @param engine The engine running the search.
+ * @param game The position to search. It is copied.
+ * @param limits The depth, time and thread limits of the search.
+ */
+template <typename TGame>
+AsyncSearch<TGame>::AsyncSearch(AlphaBeta<TGame> &engine, const TGame &game, const SearchLimits &limits)
+    : shared(std::make_unique<Shared>(game))
+{
+    std::promise<SearchResult> promise;
+    result = promise.get_future().share();
+    thread = std::thread([&engine, limits, state = shared.get(), promise = std::move(promise)]() mutable
+    {
+        engine.setStopSignal(&state->stop);
+        engine.setIterationListener([state](const int depth, const int move, int)
+        {
+            state->bestMove.store(move, std::memory_order_relaxed);
+            state->completedDepth.store(depth, std::memory_order_relaxed);
+        });
+
+        SearchResult searchResult = engine.findBestMove(state->game, limits);
+
+        engine.setIterationListener({});
+        engine.setStopSignal(nullptr);
+        state->bestMove.store(searchResult.move, std::memory_order_relaxed);
+        state->done.store(true, std::memory_order_release);
+        promise.set_value(std::move(searchResult));
+    });
+}
+
+/**
+ * @brief Cancels the search and waits for its thread.
+ */
+template <typename TGame>
+AsyncSearch<TGame>::~AsyncSearch()
+{
+    if (!thread.joinable()) return; // Moved from.
+    cancel();
+    thread.join();
+}
+
+/**
+ * @brief Checks whether the search is over.
+ * @return true if the result is available, false otherwise.
+ */
+template <typename TGame>
+bool AsyncSearch<TGame>::poll() const
+{
+    return shared->done.load(std::memory_order_acquire);
+}
+
+/**
+ * @brief Gets the best move found so far.
+ * @return The move of the deepest completed iteration, or -1 if none completed yet.
+ */
+template <typename TGame>
+int AsyncSearch<TGame>::bestSoFar() const
+{
+    return shared->bestMove.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Gets the depth searched so far.
+ * @return The depth of the deepest completed iteration, or -1 if none completed yet.
+ */
+template <typename TGame>
+int AsyncSearch<TGame>::completedDepth() const
+{
+    return shared->completedDepth.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Asks the search to stop as soon as possible. The result becomes available shortly after.
+ */
+template <typename TGame>
+void AsyncSearch<TGame>::cancel()
+{
+    shared->stop.store(true, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Gets the future result of the search.
+ * @return A future holding the result once the search is over.
+ */
+template <typename TGame>
+std::shared_future<SearchResult> AsyncSearch<TGame>::future() const
+{
+    return result;
+}
+
+/**
+ * @brief Waits for the search to end, cancelling it if it lasts longer than a deadline.
+ * @param timeout The time to wait before cancelling the search.
+ * @return The result of the search.
+ */
+template <typename TGame>
+SearchResult AsyncSearch<TGame>::waitFor(const std::chrono::milliseconds timeout)
+{
+    if (result.wait_for(timeout) != std::future_status::ready) cancel();
+    return result.get();
+}
+
+#endif //ASYNCSEARCH_H
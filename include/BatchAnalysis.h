@@ -0,0 +1,57 @@
+/**
+ * @file BatchAnalysis.h
+ * @brief Declaration of the offline analysis of a stream of positions.
+ */
+
+#ifndef BATCHANALYSIS_H
+#define BATCHANALYSIS_H
+
+#include <TranspositionTable.h>
+#include <chrono>
+#include <cstddef>
+#include <istream>
+#include <ostream>
+
+/**
+ * @struct AnalysisOptions
+ * @brief The settings of a batch analysis.
+ */
+struct AnalysisOptions {
+    int threads = 1; ///< The number of positions analyzed in parallel, each searching on one thread.
+    std::size_t ttSizeMb = DEFAULT_TT_SIZE_MB; ///< The size of the transposition table of each thread and game, in MiB.
+    std::chrono::milliseconds timeBudget{0}; ///< The time of each search, or 0 for the default of the game.
+    int maxDepth = 0; ///< The depth of each search, or 0 for the default of the game.
+    std::size_t chunkSize = 4096; ///< The number of lines read, then analyzed together, at a time.
+};
+
+/**
+ * @struct AnalysisReport
+ * @brief The totals of a batch analysis.
+ */
+struct AnalysisReport {
+    long long positions = 0; ///< The number of lines read.
+    long long errors = 0; ///< The number of lines that were not a valid position.
+    double seconds = 0; ///< The wall-clock time of the analysis.
+};
+
+/**
+ * @brief Finds the best move of every position of a stream.
+ *
+ * Each input line is a game name, `tictactoe`, `connect4` or `sticks`, followed by the
+ * encoding of a position given by `toString()`, e.g. `connect4 ......./......./......./......./......./...X... O`.
+ * Each output line, in the order of the input, is `<move> <score>` with the score of the search,
+ * positive when it favors the AI, `-1 <score>` when the game is over, or `ERR <message>`.
+ *
+ * The lines are read a chunk at a time, so the stream may be much larger than the memory. The
+ * positions of a chunk are dealt to a thread pool; each thread keeps its engines, and their
+ * transposition tables, for all its positions. A search may therefore reuse deeper results of
+ * earlier positions, so a score can depend on how the positions were dealt to the threads. An
+ * engine's table is cleared when the board size, alignment or maximum take of its game changes.
+ * @param input The positions, one per line.
+ * @param output Receives one result per line.
+ * @param options The settings of the analysis.
+ * @return The totals of the analysis.
+ */
+AnalysisReport analyzePositions(std::istream &input, std::ostream &output, const AnalysisOptions &options);
+
+#endif //BATCHANALYSIS_H
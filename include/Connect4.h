@@ -1,29 +1,265 @@
 /**
  * @file Connect4.h
- * @brief Declaration of the Connect 4 game class.
+ * @brief Declaration and implementation of the Connect 4 game class, for any board size.
  */
 
 #ifndef CONNECT4_H
 #define CONNECT4_H
 
+#include <Connect4Eval.h>
 #include <Game.h>
+#include <Zobrist.h>
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <type_traits>
 #include <vector>
 
-constexpr int BOARD_LENGTH = 7; ///< The number of columns in the Connect 4 board.
-constexpr int BOARD_HEIGHT = 6; ///< The number of rows in the Connect 4 board.
+namespace Connect4Layout
+{
+    /**
+     * @brief Gets the score of a window by the number of pieces of its only player.
+     *
+     * A window missing one piece scores 10, missing two 3, and missing three 1.
+     * A full window is a win, scored by evaluate().
+     * @tparam N The number of aligned pieces winning the game.
+     * @param pieces The number of pieces in the window.
+     * @return The score of the window.
+     */
+    template <int N>
+    constexpr int windowWeight(const int pieces)
+    {
+        constexpr int weights[4] = {0, 10, 3, 1}; // By the number of missing pieces.
+        const int missing = N - pieces;
+        return pieces == 0 || missing < 1 || missing > 3 ? 0 : weights[missing];
+    }
+
+    constexpr int CENTER_WEIGHT = 2; ///< Score of a piece in the center column.
+
+    /**
+     * @struct Layout
+     * @brief The bitboard layout of a board size and its tables, generated at compile time.
+     *
+     * Bit `col * COLUMN_BITS + row` is the cell of column `col` at height `row` (0 being the bottom row).
+     * @tparam W The number of columns.
+     * @tparam H The number of rows.
+     * @tparam N The number of aligned pieces winning the game.
+     */
+    template <int W, int H, int N>
+    struct Layout {
+        static_assert(W >= 1 && H >= 1 && W <= MAX_MOVES, "The board needs at least one cell and at most MAX_MOVES columns.");
+        static_assert(N >= 1 && (N <= W || N <= H), "The alignment must fit in the board.");
+
+        static constexpr int COLUMN_BITS = H + 1; ///< Bits per column in a bitboard, including one empty sentinel row.
+        static constexpr int BITS = W * COLUMN_BITS; ///< The number of bits of a bitboard.
+
+#ifdef __SIZEOF_INT128__
+        static_assert(BITS <= 128, "The Connect 4 board must fit in a 128-bit bitboard.");
+        /// The bitboard type: 64 bits when the board fits, 128 bits otherwise.
+        using Bitboard = std::conditional_t<BITS <= 64, uint64_t, unsigned __int128>;
+#else
+        static_assert(BITS <= 64, "The Connect 4 board must fit in a 64-bit bitboard.");
+        using Bitboard = uint64_t; ///< The bitboard type.
+#endif
+
+        /// The number of windows of N aligned cells: horizontal, vertical, and the two diagonals.
+        static constexpr int WINDOW_COUNT = (W >= N ? (W - N + 1) * H : 0) + (H >= N ? W * (H - N + 1) : 0)
+                                          + (W >= N && H >= N ? 2 * (W - N + 1) * (H - N + 1) : 0)
+                                          - (N == 1 ? 3 * W * H : 0); // A single cell is one window, not four.
+        static constexpr int MAX_WINDOWS_PER_CELL = 4 * N; ///< A cell belongs to at most N windows in each of the 4 directions.
+
+        /// Zobrist keys of the PLAYER pieces, indexed by bitboard position.
+        static constexpr auto PLAYER_KEYS = Zobrist::makeKeys<BITS>(1000);
+        /// Zobrist keys of the AI pieces, indexed by bitboard position.
+        static constexpr auto AI_KEYS = Zobrist::makeKeys<BITS>(2000);
+
+        /// The score of a won game. No heuristic score reaches it.
+        static constexpr int WIN_SCORE = std::max(1000, WINDOW_COUNT * windowWeight<N>(N - 1) + H * CENTER_WEIGHT + 1);
+
+        /**
+         * @struct WindowTable
+         * @brief The windows of N aligned cells and, for each cell, the windows containing it.
+         */
+        struct WindowTable {
+            int count = 0; ///< The number of windows.
+            int cellCount[BITS] = {}; ///< The number of windows containing each cell.
+            int cellWindows[BITS][MAX_WINDOWS_PER_CELL] = {}; ///< The windows containing each cell.
+        };
+
+        /// The windows of the board.
+        static constexpr WindowTable WINDOW_TABLE = []
+        {
+            WindowTable table;
+            // Directions as (column, row) steps: horizontal, vertical, and the two diagonals.
+            constexpr int directions[4][2] = {{1, 0}, {0, 1}, {1, 1}, {1, -1}};
+            for (int d = 0; d < (N == 1 ? 1 : 4); ++d)
+            {
+                for (int col = 0; col < W; ++col)
+                {
+                    for (int row = 0; row < H; ++row)
+                    {
+                        const int lastCol = col + (N - 1) * directions[d][0];
+                        const int lastRow = row + (N - 1) * directions[d][1];
+                        if (lastCol >= W || lastRow < 0 || lastRow >= H) continue;
+
+                        for (int k = 0; k < N; ++k)
+                        {
+                            const int bit = (col + k * directions[d][0]) * COLUMN_BITS + row + k * directions[d][1];
+                            table.cellWindows[bit][table.cellCount[bit]++] = table.count;
+                        }
+                        ++table.count;
+                    }
+                }
+            }
+            return table;
+        }();
+
+        static_assert(WINDOW_TABLE.count == WINDOW_COUNT, "Every window of the board must be listed.");
+
+        static constexpr int CONNECT = N; ///< The number of aligned pieces winning the game.
+        /// The bit distance between neighbours in each direction of the windows of WINDOW_TABLE.
+        static constexpr int WINDOW_SHIFTS[4] = {COLUMN_BITS, 1, COLUMN_BITS + 1, COLUMN_BITS - 1};
+        /// The first cell of every window, in each direction of WINDOW_SHIFTS.
+        static constexpr auto WINDOW_STARTS = []
+        {
+            std::array<Bitboard, 4> starts{};
+            constexpr int directions[4][2] = {{1, 0}, {0, 1}, {1, 1}, {1, -1}};
+            for (int d = 0; d < 4; ++d)
+            {
+                for (int col = 0; col + (N - 1) * directions[d][0] < W; ++col)
+                {
+                    for (int row = 0; row < H; ++row)
+                    {
+                        const int lastRow = row + (N - 1) * directions[d][1];
+                        if (lastRow >= 0 && lastRow < H) starts[d] |= Bitboard{1} << (col * COLUMN_BITS + row);
+                    }
+                }
+            }
+            return starts;
+        }();
+        /// The cells of the center column, worth CENTER_SCORE each.
+        static constexpr Bitboard CENTER_MASK = ((Bitboard{1} << H) - 1) << (W / 2 * COLUMN_BITS);
+        /// The cells of the board, without the sentinel rows.
+        static constexpr Bitboard BOARD_MASK = []
+        {
+            Bitboard mask = 0;
+            for (int col = 0; col < W; ++col) mask |= ((Bitboard{1} << H) - 1) << (col * COLUMN_BITS);
+            return mask;
+        }();
+        /// The score of a window of a single player, by its number of pieces.
+        static constexpr auto WINDOW_WEIGHTS = []
+        {
+            std::array<int, N + 1> weights{};
+            for (int pieces = 0; pieces <= N; ++pieces) weights[pieces] = windowWeight<N>(pieces);
+            return weights;
+        }();
+        static constexpr int CENTER_SCORE = CENTER_WEIGHT; ///< Score of a piece in the center column, for the kernels.
+
+        /// Score of a window by its number of AI and PLAYER pieces, positive when it favors the AI.
+        /// A window holding pieces of both players can no longer be completed and scores 0.
+        static constexpr auto WINDOW_SCORES = []
+        {
+            std::array<std::array<int, N + 1>, N + 1> scores{};
+            for (int ai = 0; ai <= N; ++ai)
+            {
+                for (int player = 0; player <= N; ++player)
+                {
+                    if (player == 0) scores[ai][player] = windowWeight<N>(ai);
+                    else if (ai == 0) scores[ai][player] = -windowWeight<N>(player);
+                }
+            }
+            return scores;
+        }();
+    };
+}
 
 /**
- * @class Connect4
- * @brief Represents the Connect 4 game and its logic.
+ * @class BasicConnect4
+ * @brief Represents the Connect 4 game and its logic, on a board of any size.
  *
  * This class handles the state of the Connect 4 game board, player actions,
  * and game evaluation, including determining valid moves and checking for a winner.
+ * It is a `PlayableGame` of fixed size and trivially copyable, so the searches can copy a position
+ * instead of undoing its moves; GameAdapter plays it through the `Game` interface.
+ *
+ * The board is stored as one bitboard per player. Bit `col * COLUMN_BITS + row` is the cell of
+ * column `col` at height `row` (0 being the bottom row). The extra sentinel row on top of each
+ * column is always empty, so shifting a bitboard never carries an alignment from one column into
+ * the next. The size is a template parameter, so each variant gets its own layout, tables and
+ * win check at compile time: a 64-bit bitboard when the board fits, 128 bits otherwise.
+ *
+ * Positions without a winner are scored by a heuristic over the windows of N aligned cells:
+ * a window holding pieces of a single player scores for that player, more the more pieces it
+ * holds, and each piece in the center column adds a bonus. The score is updated incrementally by
+ * `makeMove`/`undoMove`, which only rescore the windows through the changed cell. The vectorized
+ * kernels of `Connect4Eval` compute the same score from the bitboards alone, for several boards at
+ * once: `evaluateMoves` uses them to score all the children of a position without playing them.
+ *
+ * The winner is cached the same way: only the player making a move can complete an alignment,
+ * so `makeMove` checks the bitboard of that player alone, and `undoMove` clears the winner when
+ * it undoes the winning move. `getWinner`, `isTerminal` and `evaluate` then only read the cache.
+ * @tparam W The number of columns.
+ * @tparam H The number of rows.
+ * @tparam N The number of aligned pieces winning the game.
  */
-class Connect4 final : public Game{
+template <int W, int H, int N>
+class BasicConnect4 final : public Players {
+private:
+    using Layout = Connect4Layout::Layout<W, H, N>; ///< The bitboard layout and the tables of the board.
+    using Bitboard = typename Layout::Bitboard; ///< The bitboard type.
+
+public:
+    static constexpr int WIDTH = W; ///< The number of columns.
+    static constexpr int HEIGHT = H; ///< The number of rows.
+    static constexpr int CONNECT = N; ///< The number of aligned pieces winning the game.
+    static constexpr int COLUMN_BITS = Layout::COLUMN_BITS; ///< Bits per column in a bitboard, including one empty sentinel row.
+    static constexpr int WIN_SCORE = Layout::WIN_SCORE; ///< The score of a won game. No heuristic score reaches it.
+
 private:
-    int board[BOARD_HEIGHT][BOARD_LENGTH]; ///< 2D array representing the Connect 4 board.
+    Bitboard playerMask = 0; ///< Bitboard of the cells occupied by the PLAYER.
+    Bitboard aiMask = 0; ///< Bitboard of the cells occupied by the AI.
+    int heights[W]; ///< The number of pieces in each column.
     int currentPlayer = 1; ///< The current player (1 for PLAYER, -1 for AI).
+    uint64_t hash = 0; ///< Zobrist hash of the board and of the player to move.
+    uint64_t mirrorHash = 0; ///< Zobrist hash of the board mirrored left to right, and of the player to move.
+    int heuristic = 0; ///< Heuristic score of the board, positive when it favors the AI.
+    int pieceCount = 0; ///< The number of pieces on the board.
+    int winner = 0; ///< The marker of the winner (PLAYER or AI), or 0 if there is none.
+    int winningCount = 0; ///< The number of pieces on the board when the winner completed an alignment.
+    uint8_t windowPieces[2][Layout::WINDOW_COUNT]; ///< The number of AI (index 0) and PLAYER (index 1) pieces in each window.
+
+    /**
+     * @brief Checks if a bitboard contains N aligned pieces.
+     *
+     * Each direction is tested with shift-and-AND steps doubling the length of the runs found,
+     * about log2(N) steps, unrolled at compile time.
+     * @param mask The bitboard to check.
+     * @return true if the bitboard contains N consecutive pieces in any direction, false otherwise.
+     */
+    [[nodiscard]] static bool hasAlignment(Bitboard mask);
+
+    /**
+     * @brief Checks if a bitboard contains N aligned pieces in one direction.
+     * @tparam SHIFT The bit distance between neighbours in the direction.
+     * @param mask The bitboard to check.
+     * @return true if the bitboard contains N consecutive pieces in the direction, false otherwise.
+     */
+    template <int SHIFT>
+    [[nodiscard]] static bool hasAlignment(Bitboard mask);
+
+    /**
+     * @brief Updates the heuristic score after a piece is added to or removed from a cell.
+     *
+     * Only the windows containing the cell are rescored.
+     * @param bit The bitboard position of the cell.
+     * @param side 0 for an AI piece, 1 for a PLAYER piece.
+     * @param delta 1 when the piece is added, -1 when it is removed.
+     */
+    void updateHeuristic(int bit, int side, int delta);
 
 public:
     /**
@@ -32,13 +268,19 @@ public:
      * Initializes the Connect 4 board with empty cells.
      * @param userIsStarting A boolean indicating if the user is the starting player.
      */
-    explicit Connect4(const bool userIsStarting = true) : board(), currentPlayer(userIsStarting ? PLAYER : AI) {}
+    explicit BasicConnect4(bool userIsStarting = true);
+
+    /**
+     * @brief Gets the parameters of the game not given by its type, shared by the positions of the same variant.
+     * @return An empty string: the size of the board is a template parameter.
+     */
+    [[nodiscard]] std::string getVariant() const;
 
     /**
      * @brief Gets the current player in the game.
      * @return An integer representing the current player (AI or PLAYER).
      */
-    [[nodiscard]] int getCurrentPlayer() const override;
+    [[nodiscard]] int getCurrentPlayer() const;
 
     /**
      * @brief Displays the current state of the Connect 4 board.
@@ -46,7 +288,7 @@ public:
      * The board is displayed with X for the player, O for the AI, and . for empty cells.
      * Column numbers are displayed below the board for reference.
      */
-    void display() const override;
+    void display() const;
 
     /**
      * @brief Checks if the game is in a terminal state.
@@ -54,7 +296,7 @@ public:
      * A terminal state occurs when there is a winner or no more moves are available.
      * @return true if the game is over, false otherwise.
      */
-    [[nodiscard]] bool isTerminal() const override;
+    [[nodiscard]] bool isTerminal() const;
 
     /**
      * @brief Gets all valid moves (columns) in the current game state.
@@ -62,7 +304,19 @@ public:
      * A valid move is any column that is not full.
      * @return A vector of integers representing the indices of available columns.
      */
-    [[nodiscard]] std::vector<int> getAvailableMoves() const override;
+    [[nodiscard]] std::vector<int> getAvailableMoves() const;
+
+    /**
+     * @brief Writes all valid moves (columns) into a move list.
+     * @param moves The list to fill with the indices of the columns that are not full.
+     */
+    void generateMoves(MoveList &moves) const;
+
+    /**
+     * @brief Checks if at least one column is not full.
+     * @return true if a move can be made, false otherwise.
+     */
+    [[nodiscard]] bool hasMoves() const;
 
     /**
      * @brief Makes a move in the specified column.
@@ -70,7 +324,7 @@ public:
      * The move is applied to the lowest available row in the column.
      * @param col The index of the column where the move is made.
      */
-    void makeMove(int col) override;
+    void makeMove(int col);
 
     /**
      * @brief Undoes the last move made in the specified column.
@@ -78,22 +332,75 @@ public:
      * The topmost occupied row in the column is cleared.
      * @param col The index of the column to undo the move.
      */
-    void undoMove(int col) override;
+    void undoMove(int col);
 
     /**
      * @brief Evaluates the current board state.
      *
-     * @return 10 if the AI wins, -10 if the player wins, 0 otherwise.
+     * @return WIN_SCORE if the AI wins, -WIN_SCORE if the player wins, 0 for a draw,
+     *         and the heuristic score of the board while the game is ongoing.
      */
-    [[nodiscard]] int evaluate() const override;
+    [[nodiscard]] int evaluate() const;
+
+    /**
+     * @brief Evaluates the positions reached by each of a list of moves, without making them.
+     *
+     * The children are scored together by the vectorized kernel of `Connect4Eval`, as if each move
+     * were made, `evaluate()` called and the move undone.
+     * @param moves The moves, in columns that are not full.
+     * @param scores Receives the evaluation of the position after each move.
+     * @param terminal Receives whether each move ends the game.
+     */
+    void evaluateMoves(const MoveList &moves, int* scores, bool* terminal) const;
 
     /**
      * @brief Determines the winner of the game.
      *
-     * Checks for four consecutive identical markers in any direction (horizontal, vertical, diagonal).
+     * The winner is the first player whose move completed N consecutive identical markers in any
+     * direction (horizontal, vertical, diagonal), cached by makeMove().
      * @return The marker of the winner (PLAYER or AI), or 0 if there is no winner.
      */
-    [[nodiscard]] int getWinner() const override;
+    [[nodiscard]] int getWinner() const;
+
+    /**
+     * @brief Gets the Zobrist hash of the current board.
+     * @return A 64-bit hash of the board and of the player to move.
+     */
+    [[nodiscard]] uint64_t getHash() const;
+
+    /**
+     * @brief Gets the hash shared by the board and its mirror image.
+     * @return The smaller of the hashes of the board and of its mirror image.
+     */
+    [[nodiscard]] uint64_t getCanonicalHash() const;
+
+    /**
+     * @brief Maps a column to the same column on the canonical image of the board.
+     * @param move The column.
+     * @return The mirrored column if the mirror image is the canonical one, the column otherwise.
+     */
+    [[nodiscard]] int toCanonicalMove(int move) const;
+
+    /**
+     * @brief Maps a column of the canonical image of the board back to the board.
+     * @param move A column of the canonical image.
+     * @return The mirrored column if the mirror image is the canonical one, the column otherwise.
+     */
+    [[nodiscard]] int fromCanonicalMove(int move) const;
+
+    /**
+     * @brief Encodes the board as a line of text.
+     * @return The rows from top to bottom, separated by `/`, then the player to move.
+     */
+    [[nodiscard]] std::string toString() const;
+
+    /**
+     * @brief Decodes a board encoded by toString().
+     * @param text The encoding: the rows from top to bottom separated by `/`, each cell being `X`,
+     *             `O` or `.`, then the player to move, `X` or `O`. For instance `.../.X./OX. O`.
+     * @return The board, or nothing if the text is not a valid board of this size.
+     */
+    [[nodiscard]] static std::optional<BasicConnect4> fromString(const std::string &text);
 
     /**
      * @brief Checks if the player's input column is valid.
@@ -102,16 +409,471 @@ public:
      * @param col The index of the column to check.
      * @return true if the input is valid, false otherwise.
      */
-    [[nodiscard]] bool checkInput(int col) const override;
+    [[nodiscard]] bool checkInput(int col) const;
 
     /**
      * @brief Prompts the player for their input.
      *
      * @return The index of the column chosen by the player.
      */
-    [[nodiscard]] int askInput() const override;
+    [[nodiscard]] int askInput() const;
 };
 
+using Connect4 = BasicConnect4<7, 6, 4>; ///< The classic Connect 4 board: 7 columns, 6 rows, 4 in a row.
+using Connect4Large = BasicConnect4<8, 7, 4>; ///< A larger variant, still fitting a 64-bit bitboard.
+using Connect4Wide = BasicConnect4<9, 7, 4>; ///< A wider variant, on a 128-bit bitboard.
+
+static_assert(std::is_trivially_copyable_v<Connect4>, "The searches copy the boards instead of undoing moves.");
+static_assert(std::is_trivially_copyable_v<Connect4Wide>, "The searches copy the boards instead of undoing moves.");
+
+// The classic board is compiled once, in Connect4.cpp.
+extern template class BasicConnect4<7, 6, 4>;
+
+/**
+ * @brief Default constructor.
+ *
+ * Initializes the Connect 4 board with empty cells.
+ * @param userIsStarting A boolean indicating if the user is the starting player.
+ */
+template <int W, int H, int N>
+BasicConnect4<W, H, N>::BasicConnect4(const bool userIsStarting)
+    : heights(), currentPlayer(userIsStarting ? PLAYER : AI), hash(userIsStarting ? 0 : Zobrist::SIDE_KEY),
+      mirrorHash(hash), windowPieces() {}
+
+/**
+ * @brief Gets the parameters of the game not given by its type, shared by the positions of the same variant.
+ * @return An empty string: the size of the board is a template parameter.
+ */
+template <int W, int H, int N>
+std::string BasicConnect4<W, H, N>::getVariant() const
+{
+    return "";
+}
+
+/**
+ * @brief Gets the current player in the game.
+ * @return An integer representing the current player (AI or PLAYER).
+ */
+template <int W, int H, int N>
+int BasicConnect4<W, H, N>::getCurrentPlayer() const
+{
+    return currentPlayer;
+}
 
+/**
+ * @brief Displays the current state of the Connect 4 board.
+ *
+ * The board is displayed with X for the player, O for the AI, and . for empty cells.
+ * Column numbers are displayed below the board for reference.
+ */
+template <int W, int H, int N>
+void BasicConnect4<W, H, N>::display() const
+{
+    for (int row = H - 1; row >= 0; --row)
+    {
+        for (int col = 0; col < W; ++col)
+        {
+            const Bitboard cell = Bitboard{1} << (col * COLUMN_BITS + row);
+            if (playerMask & cell) std::cout << "X ";
+            else if (aiMask & cell) std::cout << "O ";
+            else  std::cout << ". ";
+        }
+        std::cout << "\n";
+    }
+    std::cout << "\n";
+    for (int i = 0; i < W; ++i)
+    {
+        std::cout << i + 1 << " "; // Display column numbers
+    }
+    std::cout << "\n";
+}
+
+/**
+ * @brief Checks if the game is in a terminal state.
+ *
+ * A terminal state occurs when there is a winner or no more moves are available.
+ * @return true if the game is over, false otherwise.
+ */
+template <int W, int H, int N>
+bool BasicConnect4<W, H, N>::isTerminal() const
+{
+    return getWinner() != 0 || !hasMoves();
+}
+
+/**
+ * @brief Gets all valid moves (columns) in the current game state.
+ *
+ * A valid move is any column that is not full.
+ * @return A vector of integers representing the indices of available columns.
+ */
+template <int W, int H, int N>
+std::vector<int> BasicConnect4<W, H, N>::getAvailableMoves() const
+{
+    MoveList moves;
+    generateMoves(moves);
+    return {moves.begin(), moves.end()};
+}
+
+/**
+ * @brief Writes all valid moves (columns) into a move list.
+ * @param moves The list to fill with the indices of the columns that are not full.
+ */
+template <int W, int H, int N>
+void BasicConnect4<W, H, N>::generateMoves(MoveList &moves) const
+{
+    moves.clear();
+    for (int col = 0; col < W; ++col)
+    {
+        if (heights[col] < H) moves.add(col);
+    }
+}
+
+/**
+ * @brief Checks if at least one column is not full.
+ * @return true if a move can be made, false otherwise.
+ */
+template <int W, int H, int N>
+bool BasicConnect4<W, H, N>::hasMoves() const
+{
+    return pieceCount < W * H;
+}
+
+/**
+ * @brief Makes a move in the specified column.
+ *
+ * The move is applied to the lowest available row in the column.
+ * @param col The index of the column where the move is made.
+ */
+template <int W, int H, int N>
+void BasicConnect4<W, H, N>::makeMove(const int col)
+{
+    if (heights[col] >= H) return; // The column is full.
+
+    const int mirrorBit = (W - 1 - col) * COLUMN_BITS + heights[col];
+    const int bit = col * COLUMN_BITS + heights[col]++;
+    if (currentPlayer == PLAYER)
+    {
+        playerMask |= Bitboard{1} << bit;
+        hash ^= Layout::PLAYER_KEYS[bit];
+        mirrorHash ^= Layout::PLAYER_KEYS[mirrorBit];
+    }
+    else
+    {
+        aiMask |= Bitboard{1} << bit;
+        hash ^= Layout::AI_KEYS[bit];
+        mirrorHash ^= Layout::AI_KEYS[mirrorBit];
+    }
+    updateHeuristic(bit, currentPlayer == AI ? 0 : 1, 1);
+    ++pieceCount;
+    if (winner == 0 && hasAlignment(currentPlayer == PLAYER ? playerMask : aiMask))
+    {
+        winner = currentPlayer;
+        winningCount = pieceCount;
+    }
+    hash ^= Zobrist::SIDE_KEY;
+    mirrorHash ^= Zobrist::SIDE_KEY;
+    currentPlayer = (currentPlayer == PLAYER) ? AI : PLAYER;
+}
+
+/**
+ * @brief Undoes the last move made in the specified column.
+ *
+ * The topmost occupied row in the column is cleared.
+ * @param col The index of the column to undo the move.
+ */
+template <int W, int H, int N>
+void BasicConnect4<W, H, N>::undoMove(const int col)
+{
+    if (heights[col] <= 0) return; // The column is empty.
+
+    const int bit = col * COLUMN_BITS + --heights[col];
+    const int mirrorBit = (W - 1 - col) * COLUMN_BITS + heights[col];
+    const bool isAiPiece = (aiMask & Bitboard{1} << bit) != 0;
+    if (!isAiPiece)
+    {
+        playerMask &= ~(Bitboard{1} << bit);
+        hash ^= Layout::PLAYER_KEYS[bit];
+        mirrorHash ^= Layout::PLAYER_KEYS[mirrorBit];
+    }
+    else
+    {
+        aiMask &= ~(Bitboard{1} << bit);
+        hash ^= Layout::AI_KEYS[bit];
+        mirrorHash ^= Layout::AI_KEYS[mirrorBit];
+    }
+    updateHeuristic(bit, isAiPiece ? 0 : 1, -1);
+    if (pieceCount == winningCount) winner = 0; // The winning move is undone.
+    --pieceCount;
+    hash ^= Zobrist::SIDE_KEY;
+    mirrorHash ^= Zobrist::SIDE_KEY;
+    currentPlayer = (currentPlayer == PLAYER) ? AI : PLAYER;
+}
+
+/**
+ * @brief Evaluates the current board state.
+ *
+ * @return WIN_SCORE if the AI wins, -WIN_SCORE if the player wins, 0 for a draw,
+ *         and the heuristic score of the board while the game is ongoing.
+ */
+template <int W, int H, int N>
+int BasicConnect4<W, H, N>::evaluate() const
+{
+    const int winner = getWinner();
+    if (winner == AI) return WIN_SCORE; // AI wins
+    if (winner == PLAYER) return -WIN_SCORE; // Player wins
+    if (!hasMoves()) return 0; // Draw
+    return heuristic; // Ongoing game
+}
+
+/**
+ * @brief Evaluates the positions reached by each of a list of moves, without making them.
+ *
+ * Only the bitboards of the children are built; the heuristic, the winner and the draw of each
+ * child are all found by the kernel.
+ * @param moves The moves, in columns that are not full.
+ * @param scores Receives the evaluation of the position after each move.
+ * @param terminal Receives whether each move ends the game.
+ */
+template <int W, int H, int N>
+void BasicConnect4<W, H, N>::evaluateMoves(const MoveList &moves, int* scores, bool* terminal) const
+{
+    Bitboard aiBoards[MAX_MOVES];
+    Bitboard playerBoards[MAX_MOVES];
+    for (int i = 0; i < moves.size(); ++i)
+    {
+        const Bitboard piece = Bitboard{1} << (moves[i] * COLUMN_BITS + heights[moves[i]]);
+        aiBoards[i] = currentPlayer == AI ? aiMask | piece : aiMask;
+        playerBoards[i] = currentPlayer == PLAYER ? playerMask | piece : playerMask;
+    }
+    Connect4Eval::evaluateBoards<Layout>(aiBoards, playerBoards, moves.size(), scores);
+    for (int i = 0; i < moves.size(); ++i)
+    {
+        terminal[i] = scores[i] == WIN_SCORE || scores[i] == -WIN_SCORE || pieceCount + 1 == W * H;
+    }
+}
+
+/**
+ * @brief Updates the heuristic score after a piece is added to or removed from a cell.
+ *
+ * Only the windows containing the cell are rescored.
+ * @param bit The bitboard position of the cell.
+ * @param side 0 for an AI piece, 1 for a PLAYER piece.
+ * @param delta 1 when the piece is added, -1 when it is removed.
+ */
+template <int W, int H, int N>
+void BasicConnect4<W, H, N>::updateHeuristic(const int bit, const int side, const int delta)
+{
+    for (int i = 0; i < Layout::WINDOW_TABLE.cellCount[bit]; ++i)
+    {
+        const int window = Layout::WINDOW_TABLE.cellWindows[bit][i];
+        const int before = Layout::WINDOW_SCORES[windowPieces[0][window]][windowPieces[1][window]];
+        windowPieces[side][window] += delta;
+        heuristic += Layout::WINDOW_SCORES[windowPieces[0][window]][windowPieces[1][window]] - before;
+    }
+
+    if (bit / COLUMN_BITS == W / 2)
+    {
+        heuristic += delta * (side == 0 ? Connect4Layout::CENTER_WEIGHT : -Connect4Layout::CENTER_WEIGHT);
+    }
+}
+
+/**
+ * @brief Determines the winner of the game.
+ *
+ * The winner is the first player whose move completed N consecutive identical markers in any
+ * direction (horizontal, vertical, diagonal), cached by makeMove().
+ * @return The marker of the winner (PLAYER or AI), or 0 if there is no winner.
+ */
+template <int W, int H, int N>
+int BasicConnect4<W, H, N>::getWinner() const
+{
+    return winner;
+}
+
+/**
+ * @brief Gets the Zobrist hash of the current board.
+ * @return A 64-bit hash of the board and of the player to move.
+ */
+template <int W, int H, int N>
+uint64_t BasicConnect4<W, H, N>::getHash() const
+{
+    return hash;
+}
+
+/**
+ * @brief Gets the hash shared by the board and its mirror image.
+ *
+ * Both hashes are maintained by makeMove() and undoMove(), the mirrored one with the keys of the
+ * mirrored cells.
+ * @return The smaller of the hashes of the board and of its mirror image.
+ */
+template <int W, int H, int N>
+uint64_t BasicConnect4<W, H, N>::getCanonicalHash() const
+{
+    return std::min(hash, mirrorHash);
+}
+
+/**
+ * @brief Maps a column to the same column on the canonical image of the board.
+ * @param move The column.
+ * @return The mirrored column if the mirror image is the canonical one, the column otherwise.
+ */
+template <int W, int H, int N>
+int BasicConnect4<W, H, N>::toCanonicalMove(const int move) const
+{
+    return mirrorHash < hash ? W - 1 - move : move;
+}
+
+/**
+ * @brief Maps a column of the canonical image of the board back to the board.
+ *
+ * The mirror is its own inverse, so this is the same mapping as toCanonicalMove().
+ * @param move A column of the canonical image.
+ * @return The mirrored column if the mirror image is the canonical one, the column otherwise.
+ */
+template <int W, int H, int N>
+int BasicConnect4<W, H, N>::fromCanonicalMove(const int move) const
+{
+    return toCanonicalMove(move);
+}
+
+/**
+ * @brief Encodes the board as a line of text.
+ *
+ * The cells are written as displayed: `X` for PLAYER, `O` for AI, `.` when empty.
+ * @return The rows from top to bottom, separated by `/`, then the player to move.
+ */
+template <int W, int H, int N>
+std::string BasicConnect4<W, H, N>::toString() const
+{
+    std::string text;
+    for (int row = H - 1; row >= 0; --row)
+    {
+        for (int col = 0; col < W; ++col)
+        {
+            const Bitboard cell = Bitboard{1} << (col * COLUMN_BITS + row);
+            text += playerMask & cell ? 'X' : aiMask & cell ? 'O' : '.';
+        }
+        if (row > 0) text += '/';
+    }
+    text += currentPlayer == PLAYER ? " X" : " O";
+    return text;
+}
+
+/**
+ * @brief Decodes a board encoded by toString().
+ *
+ * The pieces are dropped column by column, so the hashes, the evaluation and the winner are
+ * computed as if they had been played. A piece above an empty cell, or a board where both
+ * players aligned pieces, is rejected.
+ * @param text The encoding: the rows from top to bottom separated by `/`, each cell being `X`,
+ *             `O` or `.`, then the player to move, `X` or `O`. For instance `.../.X./OX. O`.
+ * @return The board, or nothing if the text is not a valid board of this size.
+ */
+template <int W, int H, int N>
+std::optional<BasicConnect4<W, H, N>> BasicConnect4<W, H, N>::fromString(const std::string &text)
+{
+    std::istringstream input(text);
+    std::string board, side, extra;
+    if (!(input >> board >> side) || input >> extra || (side != "X" && side != "O")) return std::nullopt;
+    if (board.size() != static_cast<std::size_t>(H * (W + 1) - 1)) return std::nullopt;
+    for (int row = 1; row < H; ++row)
+    {
+        if (board[row * (W + 1) - 1] != '/') return std::nullopt;
+    }
+
+    BasicConnect4 game(true);
+    for (int col = 0; col < W; ++col)
+    {
+        bool gap = false;
+        for (int row = 0; row < H; ++row)
+        {
+            const char cell = board[(H - 1 - row) * (W + 1) + col];
+            if (cell == '.') gap = true;
+            else if ((cell != 'X' && cell != 'O') || gap) return std::nullopt;
+            else
+            {
+                game.currentPlayer = cell == 'X' ? game.PLAYER : game.AI;
+                game.makeMove(col);
+            }
+        }
+    }
+    if (hasAlignment(game.playerMask) && hasAlignment(game.aiMask)) return std::nullopt;
+
+    // Each drop toggled the player to move in the hashes; only the final player counts.
+    game.currentPlayer = side == "X" ? game.PLAYER : game.AI;
+    if ((game.pieceCount % 2 == 1) != (game.currentPlayer == game.AI))
+    {
+        game.hash ^= Zobrist::SIDE_KEY;
+        game.mirrorHash ^= Zobrist::SIDE_KEY;
+    }
+    if (game.winner != 0) game.winningCount = game.pieceCount;
+    return game;
+}
+
+/**
+ * @brief Checks if a bitboard contains N aligned pieces.
+ *
+ * Each direction is tested with shift-and-AND steps doubling the length of the runs found,
+ * about log2(N) steps, unrolled at compile time.
+ * @param mask The bitboard to check.
+ * @return true if the bitboard contains N consecutive pieces in any direction, false otherwise.
+ */
+template <int W, int H, int N>
+bool BasicConnect4<W, H, N>::hasAlignment(const Bitboard mask)
+{
+    // Bit distances between neighbours: vertical, horizontal, and the two diagonals.
+    return hasAlignment<1>(mask) || hasAlignment<COLUMN_BITS>(mask)
+        || hasAlignment<COLUMN_BITS + 1>(mask) || hasAlignment<COLUMN_BITS - 1>(mask);
+}
+
+/**
+ * @brief Checks if a bitboard contains N aligned pieces in one direction.
+ * @tparam SHIFT The bit distance between neighbours in the direction.
+ * @param mask The bitboard to check.
+ * @return true if the bitboard contains N consecutive pieces in the direction, false otherwise.
+ */
+template <int W, int H, int N>
+template <int SHIFT>
+bool BasicConnect4<W, H, N>::hasAlignment(const Bitboard mask)
+{
+    // Each bit of runs starts `length` consecutive pieces. Two runs overlapping or touching make a longer one.
+    Bitboard runs = mask;
+    int length = 1;
+    while (2 * length <= N)
+    {
+        runs &= runs >> (length * SHIFT);
+        length *= 2;
+    }
+    if (length < N) runs &= runs >> ((N - length) * SHIFT);
+    return runs != 0;
+}
+
+/**
+ * @brief Checks if the player's input column is valid.
+ *
+ * A valid column is one that exists and is not full.
+ * @param col The index of the column to check.
+ * @return true if the input is valid, false otherwise.
+ */
+template <int W, int H, int N>
+bool BasicConnect4<W, H, N>::checkInput(const int col) const
+{
+    return col >= 0 && col < W && heights[col] < H;
+}
+
+/**
+ * @brief Prompts the player for their input.
+ *
+ * @return The index of the column chosen by the player.
+ */
+template <int W, int H, int N>
+int BasicConnect4<W, H, N>::askInput() const
+{
+    int col;
+    std::cout << "Enter the column number (between 1 and " << W << "): ";
+    std::cin >> col;
+    return col - 1;
+}
 
 #endif //CONNECT4_H
@@ -0,0 +1,319 @@
+/**
+ * @file Connect4Eval.h
+ * @brief Declaration and implementation of the vectorized evaluation of Connect 4 boards.
+ */
+
+#ifndef CONNECT4EVAL_H
+#define CONNECT4EVAL_H
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MINMAX_CONNECT4_AVX2 1 ///< The AVX2 kernel is compiled, and used when the processor supports it.
+#endif
+#if defined(__GNUC__) && (defined(__SSE2__) || defined(__ARM_NEON))
+#define MINMAX_CONNECT4_LANES2 1 ///< The kernel of the baseline vector unit, SSE2 or NEON, is compiled.
+#endif
+
+/**
+ * @namespace Connect4Eval
+ * @brief Scores many Connect 4 boards at once, from their bitboards alone.
+ *
+ * Every window of N aligned cells is scored in parallel with shifts and masks: for each of the
+ * four directions, the N bitboards shifted along it are summed into bit-sliced counters, so that
+ * bit `b` of the counters holds the number of pieces of the window starting at cell `b`. The
+ * windows holding a given number of pieces of one player and none of the other are then one mask,
+ * weighted by its population count. The same operations run on one board per 64-bit lane of a
+ * vector: 4 boards per AVX2 register, 2 per SSE2 or NEON register, or 1 with the scalar fallback,
+ * chosen when the program starts from the instructions the processor supports. The vectors are
+ * GCC vector extensions, so one kernel source compiles to each instruction set.
+ *
+ * The scores equal those `BasicConnect4` maintains incrementally, so a board can be scored without
+ * replaying its moves, and the children of a position can be scored without being played.
+ */
+namespace Connect4Eval
+{
+    /**
+     * @enum Kernel
+     * @brief The instruction sets the boards can be scored with.
+     */
+    enum class Kernel {
+        Scalar, ///< One board at a time, in general-purpose registers.
+        Sse2, ///< Two boards at a time, in SSE2 registers.
+        Neon, ///< Two boards at a time, in NEON registers.
+        Avx2 ///< Four boards at a time, in AVX2 registers.
+    };
+
+    /**
+     * @brief Checks if a kernel is compiled in and supported by the processor.
+     * @param kernel The kernel.
+     * @return true if `evaluateBoards()` runs the kernel, false if it would fall back to the scalar one.
+     */
+    [[nodiscard]] bool isSupported(Kernel kernel);
+
+    /**
+     * @brief Gets the fastest kernel the processor supports, detected on the first call.
+     * @return The kernel `evaluateBoards()` uses by default.
+     */
+    [[nodiscard]] Kernel activeKernel();
+
+    /**
+     * @brief Gets the name of a kernel.
+     * @param kernel The kernel.
+     * @return The lowercase name of the kernel, e.g. "avx2".
+     */
+    [[nodiscard]] const char* kernelName(Kernel kernel);
+
+#ifdef MINMAX_CONNECT4_AVX2
+    using Lanes4 = uint64_t __attribute__((vector_size(32))); ///< Four bitboards, one AVX2 register.
+#endif
+#ifdef MINMAX_CONNECT4_LANES2
+    using Lanes2 = uint64_t __attribute__((vector_size(16))); ///< Two bitboards, one SSE2 or NEON register.
+#endif
+
+    /**
+     * @brief Replaces every 64-bit lane by the number of its bits set.
+     *
+     * The lanes are counted with shifts and masks only, which every vector instruction set has.
+     * @tparam V The bitboard type, or a vector of 64-bit bitboards.
+     * @param x The lanes to count.
+     */
+    template <typename V>
+    [[gnu::always_inline]] inline void countBits(V &x)
+    {
+#ifdef __SIZEOF_INT128__
+        if constexpr (std::is_same_v<V, unsigned __int128>)
+        {
+            x = std::popcount(static_cast<uint64_t>(x)) + std::popcount(static_cast<uint64_t>(x >> 64));
+            return;
+        }
+#endif
+        x = x - ((x >> 1) & 0x5555555555555555ULL);
+        x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+        x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+        x = x + (x >> 8);
+        x = x + (x >> 16);
+        x = (x + (x >> 32)) & 0x7FULL;
+    }
+
+    /**
+     * @brief Gets one lane of a vector, or the value itself when it is not a vector.
+     * @tparam LANES The number of lanes of V.
+     * @tparam V The bitboard type, or a vector of 64-bit bitboards.
+     * @param lanes The vector.
+     * @param lane The index of the lane.
+     * @return The value of the lane.
+     */
+    template <int LANES, typename V>
+    [[gnu::always_inline]] inline auto laneOf(const V &lanes, [[maybe_unused]] const int lane)
+    {
+        if constexpr (LANES == 1) return lanes;
+        else return static_cast<uint64_t>(lanes[lane]);
+    }
+
+    /**
+     * @brief Gets the windows whose bit-sliced counter holds a given number.
+     * @tparam PLANES The number of bits of the counters.
+     * @tparam V The bitboard type, or a vector of 64-bit bitboards.
+     * @param planes The counters, least significant bit first.
+     * @param count The number to look for.
+     * @param mask Receives the windows holding the number.
+     */
+    template <int PLANES, typename V>
+    [[gnu::always_inline]] inline void countEquals(const V (&planes)[PLANES], const int count, V &mask)
+    {
+        mask = ~V{};
+        for (int p = 0; p < PLANES; ++p)
+        {
+            mask &= (count >> p & 1) ? planes[p] : ~planes[p];
+        }
+    }
+
+    /**
+     * @brief Scores the windows of one direction of a board, or of one board per lane.
+     * @tparam TLayout The layout of the board, see `Connect4Layout::Layout`.
+     * @tparam D The index of the direction in `TLayout::WINDOW_SHIFTS`.
+     * @tparam V The bitboard type, or a vector of 64-bit bitboards.
+     * @param ai The AI pieces.
+     * @param player The PLAYER pieces.
+     * @param aiScore Receives the added score of the windows of the AI alone.
+     * @param playerScore Receives the added score of the windows of the PLAYER alone.
+     * @param aiWins Receives the added windows full of AI pieces.
+     * @param playerWins Receives the added windows full of PLAYER pieces.
+     */
+    template <typename TLayout, int D, typename V>
+    [[gnu::always_inline]] inline void scoreDirection(const V &ai, const V &player, V &aiScore, V &playerScore,
+                                                      V &aiWins, V &playerWins)
+    {
+        constexpr int N = TLayout::CONNECT;
+        constexpr int SHIFT = TLayout::WINDOW_SHIFTS[D];
+        constexpr int PLANES = std::bit_width(static_cast<unsigned>(N));
+        constexpr auto STARTS = TLayout::WINDOW_STARTS[D];
+        if constexpr (STARTS != 0)
+        {
+            // Bit b of the counters holds the number of pieces on cells b, b + SHIFT, ..., b + (N - 1) * SHIFT.
+            V aiPlanes[PLANES] = {};
+            V playerPlanes[PLANES] = {};
+            V aiAny = {};
+            V playerAny = {};
+            for (int i = 0; i < N; ++i)
+            {
+                V aiCarry = ai >> (i * SHIFT);
+                V playerCarry = player >> (i * SHIFT);
+                aiAny |= aiCarry;
+                playerAny |= playerCarry;
+                for (int p = 0; p < PLANES; ++p)
+                {
+                    const V aiNext = aiPlanes[p] & aiCarry;
+                    const V playerNext = playerPlanes[p] & playerCarry;
+                    aiPlanes[p] ^= aiCarry;
+                    playerPlanes[p] ^= playerCarry;
+                    aiCarry = aiNext;
+                    playerCarry = playerNext;
+                }
+            }
+
+            const V aiOnly = ~playerAny & STARTS;
+            const V playerOnly = ~aiAny & STARTS;
+            for (int pieces = std::max(1, N - 3); pieces < N; ++pieces)
+            {
+                V aiWindows;
+                V playerWindows;
+                countEquals(aiPlanes, pieces, aiWindows);
+                countEquals(playerPlanes, pieces, playerWindows);
+                aiWindows &= aiOnly;
+                playerWindows &= playerOnly;
+                countBits(aiWindows);
+                countBits(playerWindows);
+                aiScore += aiWindows * TLayout::WINDOW_WEIGHTS[pieces];
+                playerScore += playerWindows * TLayout::WINDOW_WEIGHTS[pieces];
+            }
+
+            V aiFull;
+            V playerFull;
+            countEquals(aiPlanes, N, aiFull);
+            countEquals(playerPlanes, N, playerFull);
+            aiWins |= aiFull & STARTS;
+            playerWins |= playerFull & STARTS;
+        }
+    }
+
+    /**
+     * @brief Evaluates boards, one per lane of a vector, like `BasicConnect4::evaluate()`.
+     * @tparam TLayout The layout of the boards, see `Connect4Layout::Layout`.
+     * @tparam V The bitboard type, or a vector of 64-bit bitboards.
+     * @tparam LANES The number of boards in a V.
+     * @param ai The AI pieces of each board.
+     * @param player The PLAYER pieces of each board.
+     * @param count The number of boards.
+     * @param scores Receives the score of each board.
+     */
+    template <typename TLayout, typename V, int LANES>
+    [[gnu::always_inline]] inline void evaluateLanes(const typename TLayout::Bitboard* ai, const typename TLayout::Bitboard* player,
+                                                     const std::size_t count, int* scores)
+    {
+        for (std::size_t first = 0; first < count; first += LANES)
+        {
+            V aiLanes = {};
+            V playerLanes = {};
+            if constexpr (LANES == 1)
+            {
+                aiLanes = ai[first];
+                playerLanes = player[first];
+            }
+            else
+            {
+                for (int lane = 0; lane < LANES && first + lane < count; ++lane)
+                {
+                    aiLanes[lane] = ai[first + lane];
+                    playerLanes[lane] = player[first + lane];
+                }
+            }
+
+            // The windows of a single cell are listed once, horizontally.
+            V aiScore = {};
+            V playerScore = {};
+            V aiWins = {};
+            V playerWins = {};
+            scoreDirection<TLayout, 0>(aiLanes, playerLanes, aiScore, playerScore, aiWins, playerWins);
+            if constexpr (TLayout::CONNECT > 1)
+            {
+                scoreDirection<TLayout, 1>(aiLanes, playerLanes, aiScore, playerScore, aiWins, playerWins);
+                scoreDirection<TLayout, 2>(aiLanes, playerLanes, aiScore, playerScore, aiWins, playerWins);
+                scoreDirection<TLayout, 3>(aiLanes, playerLanes, aiScore, playerScore, aiWins, playerWins);
+            }
+            V aiCenter = aiLanes & TLayout::CENTER_MASK;
+            V playerCenter = playerLanes & TLayout::CENTER_MASK;
+            countBits(aiCenter);
+            countBits(playerCenter);
+            aiScore += aiCenter * TLayout::CENTER_SCORE;
+            playerScore += playerCenter * TLayout::CENTER_SCORE;
+
+            for (int lane = 0; lane < LANES && first + lane < count; ++lane)
+            {
+                // Selected without branches: most children of a node differ only by their heuristic.
+                const bool full = (laneOf<LANES>(aiLanes, lane) | laneOf<LANES>(playerLanes, lane)) == TLayout::BOARD_MASK;
+                int score = static_cast<int>(laneOf<LANES>(aiScore, lane)) - static_cast<int>(laneOf<LANES>(playerScore, lane));
+                score = full ? 0 : score; // Draw
+                score = laneOf<LANES>(playerWins, lane) != 0 ? -TLayout::WIN_SCORE : score;
+                score = laneOf<LANES>(aiWins, lane) != 0 ? TLayout::WIN_SCORE : score;
+                scores[first + lane] = score;
+            }
+        }
+    }
+
+#ifdef MINMAX_CONNECT4_AVX2
+    /**
+     * @brief Evaluates 64-bit boards four at a time, with AVX2 instructions.
+     * @tparam TLayout The layout of the boards, see `Connect4Layout::Layout`.
+     * @param ai The AI pieces of each board.
+     * @param player The PLAYER pieces of each board.
+     * @param count The number of boards.
+     * @param scores Receives the score of each board.
+     */
+    template <typename TLayout>
+    [[gnu::target("avx2")]] void evaluateAvx2(const uint64_t* ai, const uint64_t* player, const std::size_t count, int* scores)
+    {
+        evaluateLanes<TLayout, Lanes4, 4>(ai, player, count, scores);
+    }
+#endif
+
+    /**
+     * @brief Evaluates boards like `BasicConnect4::evaluate()`, from their bitboards.
+     *
+     * A board whose both players have an alignment cannot be reached and is scored as an AI win.
+     * The vector kernels only hold 64-bit boards; the larger boards are scored one at a time.
+     * @tparam TLayout The layout of the boards, see `Connect4Layout::Layout`.
+     * @param ai The AI pieces of each board.
+     * @param player The PLAYER pieces of each board.
+     * @param count The number of boards.
+     * @param scores Receives the score of each board: `WIN_SCORE` when the AI has an alignment,
+     *        `-WIN_SCORE` when the PLAYER has one, 0 when the board is full, the heuristic otherwise.
+     * @param kernel The instruction set to use, which must be supported; `Scalar` always is, and
+     *        the kernels that are not compiled fall back to it.
+     */
+    template <typename TLayout>
+    void evaluateBoards(const typename TLayout::Bitboard* ai, const typename TLayout::Bitboard* player,
+                        const std::size_t count, int* scores, [[maybe_unused]] const Kernel kernel = activeKernel())
+    {
+        if constexpr (std::is_same_v<typename TLayout::Bitboard, uint64_t>)
+        {
+#ifdef MINMAX_CONNECT4_AVX2
+            if (kernel == Kernel::Avx2) return evaluateAvx2<TLayout>(ai, player, count, scores);
+#endif
+#ifdef __SSE2__
+            if (kernel == Kernel::Sse2) return evaluateLanes<TLayout, Lanes2, 2>(ai, player, count, scores);
+#endif
+#ifdef __ARM_NEON
+            if (kernel == Kernel::Neon) return evaluateLanes<TLayout, Lanes2, 2>(ai, player, count, scores);
+#endif
+        }
+        evaluateLanes<TLayout, typename TLayout::Bitboard, 1>(ai, player, count, scores);
+    }
+}
+
+#endif //CONNECT4EVAL_H
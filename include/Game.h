@@ -1,29 +1,74 @@
 /**
  * @file Game.h
- * @brief Declaration of the Game interface.
+ * @brief Declaration of the game states and of the Game interface.
  *
- * This interface defines the common structure and methods that all games must implement.
+ * A game is a plain value type: the searches are templated on it and call its methods directly.
+ * The `Game` interface exposes the same methods virtually, see GameAdapter.h.
  */
 
 #ifndef GAME_H
 #define GAME_H
 
+#include <MoveList.h>
+#include <concepts>
+#include <cstdint>
+#include <memory>
+#include <string>
 #include <vector>
 
+/**
+ * @struct Players
+ * @brief The markers of the players and of the empty cells, shared by all the games.
+ *
+ * They are static, so a game state holds nothing but its position and stays cheap to copy.
+ */
+struct Players {
+    static constexpr int AI = -1;     ///< Represents the AI player.
+    static constexpr int PLAYER = 1;  ///< Represents the human player.
+    static constexpr int EMPTY = 0;   ///< Represents an empty cell or spot in the game.
+};
+
+/**
+ * @concept PlayableGame
+ * @brief A game type the searches are specialized for.
+ *
+ * Its methods mean the same as those of the `Game` interface, but are not virtual. A copy is an
+ * independent game in the same state, so the searches may copy a position instead of undoing moves.
+ * @tparam TGame The game type.
+ */
+template <typename TGame>
+concept PlayableGame = std::derived_from<TGame, Players> && std::copyable<TGame>
+    && requires(TGame &game, const TGame &position, MoveList &moves, const int move)
+{
+    { position.getCurrentPlayer() } -> std::same_as<int>;
+    { position.isTerminal() } -> std::same_as<bool>;
+    { position.getAvailableMoves() } -> std::same_as<std::vector<int>>;
+    position.generateMoves(moves);
+    { position.hasMoves() } -> std::same_as<bool>;
+    game.makeMove(move);
+    game.undoMove(move);
+    { position.evaluate() } -> std::same_as<int>;
+    { position.getWinner() } -> std::same_as<int>;
+    { position.getHash() } -> std::same_as<uint64_t>;
+    { position.getCanonicalHash() } -> std::same_as<uint64_t>;
+    { position.toCanonicalMove(move) } -> std::same_as<int>;
+    { position.fromCanonicalMove(move) } -> std::same_as<int>;
+    { position.toString() } -> std::same_as<std::string>;
+    position.display();
+    { position.checkInput(move) } -> std::same_as<bool>;
+    { position.askInput() } -> std::same_as<int>;
+};
+
 /**
  * @class Game
  * @brief Abstract base class for all games.
  *
- * The `Game` class defines an interface for implementing various games,
- * such as Connect 4, Tic-Tac-Toe, and others. It provides pure virtual methods
- * that subclasses must override to define specific game logic.
+ * The `Game` class defines an interface for playing various games, such as Connect 4,
+ * Tic-Tac-Toe, and others, without knowing their type. It provides pure virtual methods
+ * that subclasses must override; GameAdapter implements them for any `PlayableGame`.
  */
-class Game {
+class Game : public Players {
 public:
-    const int AI = -1;     ///< Represents the AI player.
-    const int PLAYER = 1;  ///< Represents the human player.
-    const int EMPTY = 0;   ///< Represents an empty cell or spot in the game.
-
     /**
      * @brief Gets the current player in the game.
      * @return An integer representing the current player (AI or PLAYER).
@@ -55,6 +100,21 @@ public:
      */
     [[nodiscard]] virtual std::vector<int> getAvailableMoves() const = 0;
 
+    /**
+     * @brief Writes all valid moves available in the current game state into a move list.
+     *
+     * This is the allocation-free counterpart of getAvailableMoves(), used by the search.
+     * Subclasses must append the moves in the same order as getAvailableMoves().
+     * @param moves The list to fill. It is cleared first.
+     */
+    virtual void generateMoves(MoveList &moves) const = 0;
+
+    /**
+     * @brief Checks if at least one move is available, without generating the moves.
+     * @return true if a move can be made, false otherwise.
+     */
+    [[nodiscard]] virtual bool hasMoves() const = 0;
+
     /**
      * @brief Makes a move in the game.
      *
@@ -88,6 +148,56 @@ public:
      */
     [[nodiscard]] virtual int getWinner() const = 0;
 
+    /**
+     * @brief Gets the Zobrist hash of the current game state.
+     *
+     * Subclasses must maintain the hash incrementally in `makeMove` and `undoMove`.
+     * Two identical states, including the player to move, must have the same hash.
+     * @return A 64-bit hash of the game state.
+     */
+    [[nodiscard]] virtual uint64_t getHash() const = 0;
+
+    /**
+     * @brief Gets a hash shared by the positions equivalent by a symmetry of the board.
+     *
+     * It is the smallest hash of the images of the position by the symmetries of the board, so
+     * mirrored positions share their entries in the transposition table and the opening book.
+     * The moves stored there are moves of that canonical image, see toCanonicalMove().
+     * Games without symmetries keep the plain hash.
+     * @return A 64-bit hash of the canonical image of the game state.
+     */
+    [[nodiscard]] virtual uint64_t getCanonicalHash() const { return getHash(); }
+
+    /**
+     * @brief Maps a move of the current position to the same move on its canonical image.
+     * @param move The move.
+     * @return The image of the move by the symmetry giving the canonical hash.
+     */
+    [[nodiscard]] virtual int toCanonicalMove(const int move) const { return move; }
+
+    /**
+     * @brief Maps a move of the canonical image back to the current position.
+     * @param move A move of the canonical image.
+     * @return The move of the current position whose canonical image it is.
+     */
+    [[nodiscard]] virtual int fromCanonicalMove(const int move) const { return move; }
+
+    /**
+     * @brief Encodes the current game state as a line of text.
+     *
+     * The encoding is the board, then the player to move (`X` for PLAYER, `O` for AI), then the
+     * parameters of the game not given by the shape of the board, separated by spaces. Each
+     * concrete game reads it back with its static `fromString()`.
+     * @return The encoding, without a newline.
+     */
+    [[nodiscard]] virtual std::string toString() const = 0;
+
+    /**
+     * @brief Creates an independent copy of the game in its current state.
+     * @return A copy of the game, of the same concrete type.
+     */
+    [[nodiscard]] virtual std::unique_ptr<Game> clone() const = 0;
+
     /**
      * @brief Checks if the player's input is valid.
      *
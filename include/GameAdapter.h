@@ -0,0 +1,112 @@
+/**
+ * @file GameAdapter.h
+ * @brief Declaration and implementation of the adapter playing a game state through the Game interface.
+ */
+
+#ifndef GAMEADAPTER_H
+#define GAMEADAPTER_H
+
+#include <Game.h>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @class GameAdapter
+ * @brief Implements the `Game` interface by forwarding to a game state.
+ *
+ * The searches are templated on the game state and never pay for virtual calls. The adapter is
+ * for the code that does not know the type of the game, such as the console, and gives the
+ * searches its state with get(): both then see the moves made by the other.
+ * @tparam TGame The game state.
+ */
+template <typename TGame>
+class GameAdapter final : public Game {
+    static_assert(PlayableGame<TGame>, "A game must provide the methods of a PlayableGame.");
+
+private:
+    TGame game; ///< The adapted game state.
+
+public:
+    /**
+     * @brief Constructs the adapter from a game state.
+     * @param game The state, copied.
+     */
+    explicit GameAdapter(TGame game);
+
+    /**
+     * @brief Gets the adapted game state.
+     * @return The state, modified by the moves made through the adapter.
+     */
+    [[nodiscard]] TGame &get();
+
+    /**
+     * @brief Gets the adapted game state.
+     * @return The state.
+     */
+    [[nodiscard]] const TGame &get() const;
+
+    [[nodiscard]] int getCurrentPlayer() const override { return game.getCurrentPlayer(); }
+    void display() const override { game.display(); }
+    [[nodiscard]] bool isTerminal() const override { return game.isTerminal(); }
+    [[nodiscard]] std::vector<int> getAvailableMoves() const override { return game.getAvailableMoves(); }
+    void generateMoves(MoveList &moves) const override { game.generateMoves(moves); }
+    [[nodiscard]] bool hasMoves() const override { return game.hasMoves(); }
+    void makeMove(const int x) override { game.makeMove(x); }
+    void undoMove(const int x) override { game.undoMove(x); }
+    [[nodiscard]] int evaluate() const override { return game.evaluate(); }
+    [[nodiscard]] int getWinner() const override { return game.getWinner(); }
+    [[nodiscard]] uint64_t getHash() const override { return game.getHash(); }
+    [[nodiscard]] uint64_t getCanonicalHash() const override { return game.getCanonicalHash(); }
+    [[nodiscard]] int toCanonicalMove(const int move) const override { return game.toCanonicalMove(move); }
+    [[nodiscard]] int fromCanonicalMove(const int move) const override { return game.fromCanonicalMove(move); }
+    [[nodiscard]] std::string toString() const override { return game.toString(); }
+    [[nodiscard]] bool checkInput(const int input) const override { return game.checkInput(input); }
+    [[nodiscard]] int askInput() const override { return game.askInput(); }
+
+    /**
+     * @brief Creates an independent copy of the game in its current state.
+     * @return A new adapter, holding a copy of the state.
+     */
+    [[nodiscard]] std::unique_ptr<Game> clone() const override;
+};
+
+/**
+ * @brief Constructs the adapter from a game state.
+ * @param game The state, copied.
+ */
+template <typename TGame>
+GameAdapter<TGame>::GameAdapter(TGame game) : game(std::move(game)) {}
+
+/**
+ * @brief Gets the adapted game state.
+ * @return The state, modified by the moves made through the adapter.
+ */
+template <typename TGame>
+TGame &GameAdapter<TGame>::get()
+{
+    return game;
+}
+
+/**
+ * @brief Gets the adapted game state.
+ * @return The state.
+ */
+template <typename TGame>
+const TGame &GameAdapter<TGame>::get() const
+{
+    return game;
+}
+
+/**
+ * @brief Creates an independent copy of the game in its current state.
+ * @return A new adapter, holding a copy of the state.
+ */
+template <typename TGame>
+std::unique_ptr<Game> GameAdapter<TGame>::clone() const
+{
+    return std::make_unique<GameAdapter>(game);
+}
+
+#endif //GAMEADAPTER_H
@@ -0,0 +1,210 @@
+/**
+ * @file GameServer.h
+ * @brief Declaration of the GameServer class, serving games to TCP clients.
+ */
+
+#ifndef GAMESERVER_H
+#define GAMESERVER_H
+
+#include <Connect4.h>
+#include <SticksGame.h>
+#include <TicTacToe.h>
+#include <TranspositionTable.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+/// The state of a served game, held by value: the search runs on the concrete type, without virtual calls.
+using GameState = std::variant<TicTacToe, Connect4, SticksGame>;
+
+/**
+ * @struct ServerOptions
+ * @brief The settings of a game server.
+ */
+struct ServerOptions {
+    uint16_t port = 4000; ///< The TCP port to listen on.
+    int workers = 1; ///< The number of threads running searches.
+    std::size_t queueCapacity = 256; ///< The number of searches that may wait for a worker.
+    std::size_t ttSizeMb = DEFAULT_TT_SIZE_MB; ///< The size of the transposition tables of each worker, in MiB.
+    std::chrono::milliseconds timeBudget{0}; ///< The time a search may take, or 0 for the default of the game.
+};
+
+/**
+ * @class GameServer
+ * @brief Serves games against the AI to any number of TCP clients, with a line-based protocol.
+ *
+ * Every command is one line; every response is one line starting with the session it concerns:
+ * - `NEW <tictactoe|connect4|sticks> [you|ai] [parameters]` starts a session, the client
+ *   moving first unless `ai` is given. Tic-Tac-Toe takes `[rows] [columns] [alignment]` and the
+ *   Sticks game `[sticks] [take]`. Response: `OK <session>`.
+ * - `PLAY <session> <move> [deadline]` plays the client's move. The AI answers
+ *   `MOVE <session> <move>` once its search completes, or once the deadline, in milliseconds, expires.
+ * - `GO <session> [deadline]` asks the AI to move again, after a `BUSY`.
+ * - `MOVES <session>` lists the legal moves: `MOVES <session> <move>...`.
+ * - `CLOSE <session>` ends a session. Response: `OK <session>`.
+ * When a game ends, `END <session> <win|loss|draw>` follows, from the client's point of view.
+ * Errors are reported as `ERR <message>`, and `BUSY <session>` when too many searches are waiting.
+ *
+ * One thread multiplexes all the connections and never searches: searches are queued, with a copy
+ * of the session state, to a bounded pool of workers, each owning one engine per game, cleared
+ * whenever its sessions change variant. A long Connect 4 search thus occupies a single worker
+ * while the other sessions keep being served.
+ * The searches are asynchronous: a worker cancels its search when the deadline of the request
+ * expires, and when the client closes the session or disconnects.
+ */
+class GameServer final {
+private:
+    /**
+     * @struct Session
+     * @brief A game played by a client.
+     */
+    struct Session {
+        GameState state; ///< The current position.
+        bool searching = false; ///< Whether the AI is searching its move.
+        std::shared_ptr<std::atomic<bool>> cancelled{}; ///< Raised to cancel the search of the AI, while it searches.
+    };
+
+    /**
+     * @struct Connection
+     * @brief A connected client.
+     */
+    struct Connection {
+        int socket = -1; ///< The socket of the client.
+        std::string input{}; ///< The received bytes not yet forming a complete line.
+        std::string output{}; ///< The bytes waiting to be sent.
+        std::unordered_map<int, Session> sessions{}; ///< The games of the client, by session number.
+        int nextSession = 1; ///< The number of the next session.
+    };
+
+    /**
+     * @struct Job
+     * @brief A search waiting for a worker.
+     */
+    struct Job {
+        uint64_t connection; ///< The connection asking.
+        int session; ///< The session asking.
+        GameState state; ///< A copy of the position to search.
+        std::chrono::milliseconds deadline; ///< The time the search may take, or 0 for no deadline.
+        std::shared_ptr<std::atomic<bool>> cancelled; ///< Raised when nobody waits for the result anymore.
+    };
+
+    /**
+     * @struct Result
+     * @brief A completed search, waiting to be sent.
+     */
+    struct Result {
+        uint64_t connection; ///< The connection that asked.
+        int session; ///< The session that asked.
+        int move; ///< The move of the AI.
+    };
+
+    ServerOptions options; ///< The settings of the server.
+    int listener = -1; ///< The listening socket.
+    int wakeRead = -1; ///< The end of the wake-up pipe watched by the network thread.
+    int wakeWrite = -1; ///< The end of the wake-up pipe written by the workers.
+    std::atomic<bool> stopping{false}; ///< Raised to stop the server.
+
+    std::unordered_map<uint64_t, Connection> connections; ///< The clients, by connection number.
+    uint64_t nextConnection = 1; ///< The number of the next connection.
+
+    std::vector<std::thread> workers; ///< The threads running searches.
+    std::mutex jobsMutex; ///< Protects the job queue.
+    std::condition_variable jobsAvailable; ///< Signaled when a job is queued or the server stops.
+    std::deque<Job> jobs; ///< The searches waiting for a worker.
+    std::mutex resultsMutex; ///< Protects the result queue.
+    std::vector<Result> results; ///< The completed searches.
+
+    /**
+     * @brief Main loop of a worker: runs searches until the server stops.
+     */
+    void work();
+
+    /**
+     * @brief Wakes the network thread up.
+     */
+    void wake() const;
+
+    /**
+     * @brief Accepts the pending connections.
+     */
+    void acceptConnections();
+
+    /**
+     * @brief Reads from a client and executes its complete lines.
+     * @param id The number of the connection.
+     * @return false if the client disconnected, true otherwise.
+     */
+    bool readFrom(uint64_t id);
+
+    /**
+     * @brief Sends as much of the pending output of a client as possible.
+     * @param connection The client.
+     * @return false if the connection failed, true otherwise.
+     */
+    static bool writeTo(Connection &connection);
+
+    /**
+     * @brief Executes one command of a client.
+     * @param id The number of the connection.
+     * @param connection The client.
+     * @param line The command.
+     */
+    void execute(uint64_t id, Connection &connection, const std::string &line);
+
+    /**
+     * @brief Queues the search of the AI's move in a session, or reports the end of its game.
+     * @param id The number of the connection.
+     * @param connection The client.
+     * @param number The number of the session.
+     * @param deadline The time the search may take, or 0 for no deadline.
+     */
+    void continueSession(uint64_t id, Connection &connection, int number, std::chrono::milliseconds deadline);
+
+    /**
+     * @brief Cancels the searches of every session of a client.
+     * @param connection The client.
+     */
+    static void cancelSearches(Connection &connection);
+
+    /**
+     * @brief Applies the completed searches to their sessions.
+     */
+    void deliverResults();
+
+public:
+    /**
+     * @brief Constructs a server. Nothing happens until run() is called.
+     * @param options The settings of the server.
+     */
+    explicit GameServer(const ServerOptions &options);
+
+    GameServer(const GameServer &) = delete;
+    GameServer &operator=(const GameServer &) = delete;
+
+    /**
+     * @brief Stops the workers and closes every socket.
+     */
+    ~GameServer();
+
+    /**
+     * @brief Listens and serves clients until stop() is called.
+     * @return false if the server could not listen on its port, true once stopped.
+     */
+    bool run();
+
+    /**
+     * @brief Makes run() return. May be called from any thread.
+     */
+    void stop();
+};
+
+#endif //GAMESERVER_H
@@ -0,0 +1,580 @@
+/**
+ * @file Mcts.h
+ * @brief Declaration and implementation of the Monte Carlo tree search engine.
+ */
+
+#ifndef MCTS_H
+#define MCTS_H
+
+#include <Arena.h>
+#include <Game.h>
+#include <MoveList.h>
+#include <SearchStats.h>
+#include <SearchTraits.h>
+#include <ThreadPool.h>
+#include <Zobrist.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+constexpr std::size_t DEFAULT_TREE_SIZE_MB = 64; ///< The default limit of the tree of a Monte Carlo engine, in MiB.
+
+/**
+ * @class Mcts
+ * @brief Monte Carlo tree search, with the UCT selection rule.
+ *
+ * Instead of searching every move to a fixed depth and scoring the leaves with `evaluate()`, the
+ * engine plays random games to the end and grows a tree towards the moves that win most often.
+ * Each iteration:
+ * - descends from the root, choosing in every node the child maximizing its win rate plus an
+ *   exploration bonus, larger for the children visited less (UCB1);
+ * - expands the leaf it reaches on its second visit, adding all its children at once;
+ * - plays random moves until the end of the game, from the generated move lists;
+ * - adds the result to every node of the path, from the point of view of the player to move at
+ *   its parent: 1 for a win, 1/2 for a draw.
+ * The move played is the root child visited most. No evaluation function is needed, which suits
+ * the large boards where the evaluation of the alpha-beta search is too weak to look far enough.
+ *
+ * The nodes are allocated from an arena owned by the engine, the children of a node next to each
+ * other, and freed all at once when the next search starts. The arena keeps its memory, so the
+ * searches after the first do not allocate. When the tree reaches its size limit, it stops growing
+ * and the remaining playouts start from its leaves.
+ *
+ * With several threads, the search is root-parallel: helper engines grow independent trees from
+ * clones of the game, with different random moves, and the visits of the root children are summed.
+ * @tparam TGame The concrete game type.
+ */
+template <typename TGame>
+class Mcts {
+    static_assert(PlayableGame<TGame>, "A game must provide the methods of a PlayableGame.");
+
+private:
+    using Traits = SearchTraits<TGame>; ///< The search parameters of the game.
+    using Clock = std::chrono::steady_clock; ///< The clock measuring the time budget.
+
+    static constexpr double EXPLORATION = 1.4142135623730951; ///< The weight of the exploration bonus, sqrt(2).
+    static constexpr long long TIME_CHECK_INTERVAL = 64; ///< The number of playouts between two clock reads.
+    static constexpr long long DEFAULT_PLAYOUTS = 100000; ///< The playouts of a search limited neither by time nor by playouts.
+    static constexpr bool COPY_MAKE = std::is_trivially_copyable_v<TGame>; ///< Whether an iteration plays on a copy of the root instead of undoing its moves.
+
+    /**
+     * @struct Node
+     * @brief A position of the tree, reached by one move from its parent.
+     */
+    struct Node {
+        int move; ///< The move leading from the parent to this node.
+        Node* parent; ///< The parent, or nullptr for the root.
+        Node* children = nullptr; ///< The first child; the children are contiguous.
+        int childCount = 0; ///< The number of children.
+        int visits = 0; ///< The number of playouts through this node.
+        int mover = 0; ///< The player who made the move, from whose point of view the reward is counted.
+        bool expanded = false; ///< Whether the children were added, or the node is terminal.
+        double reward = 0; ///< The sum of the playout results: 1 per win of the mover, 1/2 per draw.
+    };
+
+    std::size_t capacity; ///< The number of nodes the tree may hold.
+    Arena arena; ///< The memory of the nodes of the current tree.
+    Node* root = nullptr; ///< The root of the current tree.
+    std::size_t nodeCount = 0; ///< The number of nodes of the current tree.
+    Arena clones; ///< The copies of the game searched by the helpers during the current search.
+    std::vector<int> path; ///< The moves made from the root during the current iteration.
+    uint64_t seed; ///< The seed of the random moves.
+    uint64_t randomCounter = 0; ///< The number of random numbers drawn since the seed.
+    long long playoutCount = 0; ///< The number of playouts of the last search.
+    int treeDepth = 0; ///< The depth of the deepest node of the tree, in plies below the root.
+    const std::atomic<bool>* stopSignal = nullptr; ///< When set and raised, the current search stops.
+    std::vector<std::unique_ptr<Mcts>> helpers; ///< The engines growing their own trees on the other threads.
+    std::unique_ptr<ThreadPool> pool; ///< The threads running the helpers.
+
+    /**
+     * @brief Draws a random index.
+     * @param bound The number of possible values.
+     * @return A uniformly distributed integer between 0 and bound - 1.
+     */
+    int randomIndex(int bound);
+
+    /**
+     * @brief Grows the tree of the position until the limits are reached.
+     * @param game Reference to the current game object, restored on return.
+     * @param playouts The number of playouts, or 0 for no limit.
+     * @param deadline The time at which the search must stop, if timeLimited.
+     * @param timeLimited Whether the search stops at the deadline.
+     */
+    void grow(TGame &game, long long playouts, Clock::time_point deadline, bool timeLimited);
+
+    /**
+     * @brief Runs one iteration: descends the tree, expands the leaf, plays it out and backs up the result.
+     * @param game The game in the position of the root, left in the final position of the playout.
+     */
+    void iterate(TGame &game);
+
+    /**
+     * @brief Chooses the child of a node to descend into.
+     * @param node The expanded node.
+     * @return The first unvisited child, or the child with the highest UCB1 value.
+     */
+    static Node* selectChild(const Node &node);
+
+    /**
+     * @brief Adds the children of a leaf, if the tree has room for them.
+     * @param game The game, in the position of the leaf.
+     * @param node The leaf.
+     * @return true if the leaf now has children, false if it is terminal or the tree is full.
+     */
+    bool expand(TGame &game, Node &node);
+
+    /**
+     * @brief Plays random moves until the end of the game, recording them in the path.
+     * @param game The game, left in the final position.
+     * @return The winner of the game, or 0 for a draw.
+     */
+    int playout(TGame &game);
+
+    /**
+     * @brief Adds the result of a playout to a node and its ancestors.
+     * @param node The node the playout started from.
+     * @param winner The winner of the playout, or 0 for a draw.
+     */
+    static void backpropagate(Node* node, int winner);
+
+    /**
+     * @brief Ensures that enough helper engines and threads exist.
+     * @param count The number of helpers needed.
+     */
+    void ensureHelpers(int count);
+
+    /**
+     * @brief Converts the win rate of a move into a score of the game.
+     * @param node The root child.
+     * @param visits The visits of the move, summed over the trees.
+     * @param reward The reward of the move, summed over the trees.
+     * @return The expected result between `Traits::minScore` and `Traits::maxScore`, positive when it favors the AI.
+     */
+    [[nodiscard]] static int toScore(const Node &node, int visits, double reward);
+
+public:
+    /**
+     * @brief Constructs a Monte Carlo engine.
+     * @param treeSizeMb The size limit of the tree, in MiB.
+     * @param seed The seed of the random moves. The same seed gives the same playouts.
+     */
+    explicit Mcts(std::size_t treeSizeMb = DEFAULT_TREE_SIZE_MB, uint64_t seed = 1);
+
+    /**
+     * @brief Sets a flag that stops the searches of the engine when raised.
+     * @param signal The flag, which must outlive the searches, or nullptr to never stop early.
+     */
+    void setStopSignal(const std::atomic<bool>* signal);
+
+    /**
+     * @brief Determines the best move for the player to move.
+     * @param game Reference to the current game object.
+     * @param limits The time, playout and thread limits of the search.
+     * @return The best move, or -1 if there is no move available.
+     */
+    [[nodiscard]] int getBestMove(TGame &game, const SearchLimits &limits = SearchLimits::defaults<TGame>());
+
+    /**
+     * @brief Determines the best move for the player to move, with the statistics of the search.
+     * @param game Reference to the current game object.
+     * @param limits The time, playout and thread limits of the search.
+     * @return The best move, its score, the depth of the tree and the statistics of the search.
+     */
+    [[nodiscard]] SearchResult findBestMove(TGame &game, const SearchLimits &limits = SearchLimits::defaults<TGame>());
+
+    /**
+     * @brief Gets the number of playouts of the last search.
+     * @return The number of random games played, by all threads.
+     */
+    [[nodiscard]] long long getPlayoutCount() const;
+};
+
+/**
+ * @brief Constructs a Monte Carlo engine.
+ *
+ * The tree may always hold at least the root and its children. No node is allocated until the first search.
+ * @param treeSizeMb The size limit of the tree, in MiB.
+ * @param seed The seed of the random moves. The same seed gives the same playouts.
+ */
+template <typename TGame>
+Mcts<TGame>::Mcts(const std::size_t treeSizeMb, const uint64_t seed)
+    : capacity(std::max<std::size_t>(MAX_MOVES + 1, (treeSizeMb << 20) / sizeof(Node))), seed(seed)
+{
+    path.reserve(MAX_MOVES);
+}
+
+/**
+ * @brief Draws a random index.
+ *
+ * The numbers come from the SplitMix64 sequence of the seed, mapped to the range by a multiplication.
+ * @param bound The number of possible values.
+ * @return A uniformly distributed integer between 0 and bound - 1.
+ */
+template <typename TGame>
+int Mcts<TGame>::randomIndex(const int bound)
+{
+    const uint64_t bits = Zobrist::key(seed * 0x100000000ULL + randomCounter++) >> 32;
+    return static_cast<int>((bits * static_cast<uint64_t>(bound)) >> 32);
+}
+
+/**
+ * @brief Grows the tree of the position until the limits are reached.
+ *
+ * The tree is rebuilt for every search, in the memory of the previous one. At least one playout
+ * is run, so the root is always expanded.
+ * @param game Reference to the current game object, restored on return.
+ * @param playouts The number of playouts, or 0 for no limit.
+ * @param deadline The time at which the search must stop, if timeLimited.
+ * @param timeLimited Whether the search stops at the deadline.
+ */
+template <typename TGame>
+void Mcts<TGame>::grow(TGame &game, const long long playouts, const Clock::time_point deadline, const bool timeLimited)
+{
+    arena.reset();
+    root = arena.create<Node>(Node{-1, nullptr});
+    root->mover = -game.getCurrentPlayer();
+    nodeCount = 1;
+    playoutCount = 0;
+    treeDepth = 0;
+
+    while (true)
+    {
+        // A trivially copyable game is played on a copy, dropped after the playout: copying it
+        // costs less than undoing every move of the path.
+        if constexpr (COPY_MAKE)
+        {
+            TGame position = game;
+            iterate(position);
+        }
+        else
+        {
+            iterate(game);
+            for (auto move = path.rbegin(); move != path.rend(); ++move)
+            {
+                game.undoMove(*move);
+            }
+        }
+
+        ++playoutCount;
+        if (playouts > 0 && playoutCount >= playouts) break;
+        if (playoutCount % TIME_CHECK_INTERVAL == 0)
+        {
+            if (stopSignal && stopSignal->load(std::memory_order_relaxed)) break;
+            if (timeLimited && Clock::now() >= deadline) break;
+        }
+    }
+}
+
+/**
+ * @brief Runs one iteration: descends the tree, expands the leaf, plays it out and backs up the result.
+ *
+ * The moves made are recorded in the path, for the caller to undo them.
+ * @param game The game in the position of the root, left in the final position of the playout.
+ */
+template <typename TGame>
+void Mcts<TGame>::iterate(TGame &game)
+{
+    Node* node = root;
+    path.clear();
+    while (node->expanded && node->childCount > 0)
+    {
+        node = selectChild(*node);
+        game.makeMove(node->move);
+        path.push_back(node->move);
+    }
+    treeDepth = std::max(treeDepth, static_cast<int>(path.size()));
+
+    // A leaf is only expanded once a playout went through it, so that the size limit is spent on
+    // the positions visited again.
+    if (!node->expanded && (node == root || node->visits > 0) && expand(game, *node))
+    {
+        node = node->children;
+        game.makeMove(node->move);
+        path.push_back(node->move);
+    }
+
+    backpropagate(node, playout(game));
+}
+
+/**
+ * @brief Chooses the child of a node to descend into.
+ *
+ * A child never visited has an infinite UCB1 value: the children are all tried once, in the
+ * order of the move generator, before the win rates are compared.
+ * @param node The expanded node.
+ * @return The first unvisited child, or the child with the highest UCB1 value.
+ */
+template <typename TGame>
+typename Mcts<TGame>::Node* Mcts<TGame>::selectChild(const Node &node)
+{
+    const double logVisits = std::log(static_cast<double>(node.visits));
+    Node* best = node.children;
+    double bestValue = -1;
+    for (Node* child = node.children; child < node.children + node.childCount; ++child)
+    {
+        const Node &candidate = *child;
+        if (candidate.visits == 0) return child;
+        const double value = candidate.reward / candidate.visits
+                             + EXPLORATION * std::sqrt(logVisits / candidate.visits);
+        if (value > bestValue)
+        {
+            bestValue = value;
+            best = child;
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief Adds the children of a leaf, if the tree has room for them.
+ *
+ * A terminal leaf is marked expanded without children, so the playouts reaching it stop there.
+ * @param game The game, in the position of the leaf.
+ * @param node The leaf.
+ * @return true if the leaf now has children, false if it is terminal or the tree is full.
+ */
+template <typename TGame>
+bool Mcts<TGame>::expand(TGame &game, Node &node)
+{
+    if (game.isTerminal())
+    {
+        node.expanded = true;
+        return false;
+    }
+
+    MoveList moves;
+    game.generateMoves(moves);
+    if (nodeCount + moves.size() > capacity) return false;
+
+    const int mover = game.getCurrentPlayer();
+    Node* children = arena.createArray<Node>(moves.size());
+    for (int i = 0; i < moves.size(); ++i)
+    {
+        children[i].move = moves[i];
+        children[i].parent = &node;
+        children[i].mover = mover;
+    }
+    node.children = children;
+    node.childCount = moves.size();
+    node.expanded = true;
+    nodeCount += moves.size();
+    return true;
+}
+
+/**
+ * @brief Plays random moves until the end of the game, recording them in the path.
+ * @param game The game, left in the final position.
+ * @return The winner of the game, or 0 for a draw.
+ */
+template <typename TGame>
+int Mcts<TGame>::playout(TGame &game)
+{
+    MoveList moves;
+    while (!game.isTerminal())
+    {
+        game.generateMoves(moves);
+        const int move = moves[randomIndex(moves.size())];
+        game.makeMove(move);
+        path.push_back(move);
+    }
+    return game.getWinner();
+}
+
+/**
+ * @brief Adds the result of a playout to a node and its ancestors.
+ * @param node The node the playout started from.
+ * @param winner The winner of the playout, or 0 for a draw.
+ */
+template <typename TGame>
+void Mcts<TGame>::backpropagate(Node* node, const int winner)
+{
+    for (; node; node = node->parent)
+    {
+        ++node->visits;
+        node->reward += winner == node->mover ? 1.0 : winner == 0 ? 0.5 : 0.0;
+    }
+}
+
+/**
+ * @brief Ensures that enough helper engines and threads exist.
+ *
+ * Each helper gets its own arena, the same tree size limit and its own seed.
+ * @param count The number of helpers needed.
+ */
+template <typename TGame>
+void Mcts<TGame>::ensureHelpers(const int count)
+{
+    while (static_cast<int>(helpers.size()) < count)
+    {
+        const std::size_t treeSizeMb = capacity * sizeof(Node) >> 20;
+        helpers.push_back(std::make_unique<Mcts>(treeSizeMb, seed + helpers.size() + 1));
+    }
+    if (count > 0 && (!pool || static_cast<int>(pool->size()) < count))
+    {
+        pool = std::make_unique<ThreadPool>(count);
+    }
+}
+
+/**
+ * @brief Converts the win rate of a move into a score of the game.
+ * @param node The root child.
+ * @param visits The visits of the move, summed over the trees.
+ * @param reward The reward of the move, summed over the trees.
+ * @return The expected result between `Traits::minScore` and `Traits::maxScore`, positive when it favors the AI.
+ */
+template <typename TGame>
+int Mcts<TGame>::toScore(const Node &node, const int visits, const double reward)
+{
+    if (visits == 0) return 0;
+    const double advantage = 2 * reward / visits - 1; // Between -1 and 1, for the mover.
+    const double aiAdvantage = node.mover == -1 ? advantage : -advantage;
+    return static_cast<int>(std::lround(aiAdvantage * (aiAdvantage > 0 ? Traits::maxScore : -Traits::minScore)));
+}
+
+/**
+ * @brief Sets a flag that stops the searches of the engine when raised.
+ *
+ * A stopped search returns the move visited most so far.
+ * @param signal The flag, which must outlive the searches, or nullptr to never stop early.
+ */
+template <typename TGame>
+void Mcts<TGame>::setStopSignal(const std::atomic<bool>* signal)
+{
+    stopSignal = signal;
+}
+
+/**
+ * @brief Determines the best move for the player to move.
+ * @param game Reference to the current game object.
+ * @param limits The time, playout and thread limits of the search.
+ * @return The best move, or -1 if there is no move available.
+ */
+template <typename TGame>
+int Mcts<TGame>::getBestMove(TGame &game, const SearchLimits &limits)
+{
+    return findBestMove(game, limits).move;
+}
+
+/**
+ * @brief Determines the best move for the player to move, with the statistics of the search.
+ *
+ * The search runs until the time budget or the number of playouts of the limits is reached; when
+ * neither is set, `DEFAULT_PLAYOUTS` playouts are run. The depth limit is not used. The playouts
+ * are shared between the threads.
+ *
+ * The score of the result maps the win rate of the best move onto the scores of the game, and its
+ * depth is the depth of the tree. The node count of the statistics is the number of nodes of the
+ * trees and the leaf evaluations are the playouts. The principal variation follows the most visited
+ * children of the tree of the calling thread.
+ * @param game Reference to the current game object.
+ * @param limits The time, playout and thread limits of the search.
+ * @return The best move, its score, the depth of the tree and the statistics of the search.
+ */
+template <typename TGame>
+SearchResult Mcts<TGame>::findBestMove(TGame &game, const SearchLimits &limits)
+{
+    const auto start = Clock::now();
+    SearchResult result;
+    if (game.isTerminal()) return result;
+
+    const bool timeLimited = limits.timeBudget.count() > 0;
+    const long long playouts = limits.playouts > 0 || timeLimited ? limits.playouts : DEFAULT_PLAYOUTS;
+    const Clock::time_point deadline = start + limits.timeBudget;
+    const int threads = std::max(1, limits.threads);
+
+    // Clone before any thread starts making moves on the original.
+    ensureHelpers(threads - 1);
+    clones.reset();
+    std::vector<TGame*> copies;
+    for (int worker = 1; worker < threads; ++worker)
+    {
+        copies.push_back(clones.create<TGame>(game));
+    }
+
+    std::vector<std::future<void>> trees;
+    for (int worker = 1; worker < threads; ++worker)
+    {
+        Mcts &helper = *helpers[worker - 1];
+        helper.stopSignal = stopSignal;
+        const long long share = playouts > 0 ? std::max(1LL, playouts * (worker + 1) / threads - playouts * worker / threads) : 0;
+        trees.push_back(pool->submit([&helper, &copies, worker, share, deadline, timeLimited]
+        {
+            helper.grow(*copies[worker - 1], share, deadline, timeLimited);
+        }));
+    }
+    grow(game, playouts > 0 ? std::max(1LL, playouts / threads) : 0, deadline, timeLimited);
+
+    // The trees have the same root children, in the order of the move generator.
+    const Node* children = root->children;
+    const int childCount = root->childCount;
+    std::vector<int> visits(childCount);
+    std::vector<double> rewards(childCount);
+    long long treeNodes = static_cast<long long>(nodeCount);
+    int depth = treeDepth;
+    long long totalPlayouts = playoutCount;
+    for (int i = 0; i < childCount; ++i)
+    {
+        visits[i] = children[i].visits;
+        rewards[i] = children[i].reward;
+    }
+    for (int worker = 1; worker < threads; ++worker)
+    {
+        trees[worker - 1].get();
+        const Mcts &helper = *helpers[worker - 1];
+        for (int i = 0; i < helper.root->childCount && i < childCount; ++i)
+        {
+            visits[i] += helper.root->children[i].visits;
+            rewards[i] += helper.root->children[i].reward;
+        }
+        treeNodes += static_cast<long long>(helper.nodeCount);
+        depth = std::max(depth, helper.treeDepth);
+        totalPlayouts += helper.playoutCount;
+    }
+    playoutCount = totalPlayouts;
+
+    int best = 0;
+    for (int i = 0; i < childCount; ++i)
+    {
+        result.stats.rootScores.push_back({children[i].move, toScore(children[i], visits[i], rewards[i])});
+        if (visits[i] > visits[best]) best = i;
+    }
+
+    result.move = children[best].move;
+    result.score = toScore(children[best], visits[best], rewards[best]);
+    result.depth = depth;
+    for (const Node* node = children + best; node;)
+    {
+        result.principalVariation.push_back(node->move);
+        const Node* next = nullptr;
+        for (const Node* child = node->children; child < node->children + node->childCount; ++child)
+        {
+            if (child->visits > 0 && (!next || child->visits > next->visits)) next = child;
+        }
+        node = next;
+    }
+
+    result.stats.nodes = treeNodes;
+    result.stats.leafEvaluations = totalPlayouts;
+    result.stats.maxDepth = depth;
+    result.stats.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+    return result;
+}
+
+/**
+ * @brief Gets the number of playouts of the last search.
+ * @return The number of random games played, by all threads.
+ */
+template <typename TGame>
+long long Mcts<TGame>::getPlayoutCount() const
+{
+    return playoutCount;
+}
+
+#endif //MCTS_H
@@ -0,0 +1,92 @@
+/**
+ * @file MoveList.h
+ * @brief Declaration of a fixed-capacity list of moves.
+ */
+
+#ifndef MOVELIST_H
+#define MOVELIST_H
+
+#include <cassert>
+
+constexpr int MAX_MOVES = 256; ///< The maximum number of moves available in any game state.
+
+/**
+ * @class MoveList
+ * @brief A list of moves stored inline, without heap allocation.
+ *
+ * The search declares one list per node on the stack and lets the game fill it, so generating
+ * moves never allocates. The storage is left uninitialized until moves are added.
+ */
+class MoveList {
+private:
+    int moves[MAX_MOVES]; ///< The storage of the moves.
+    int count = 0; ///< The number of moves in the list.
+
+public:
+    /**
+     * @brief Appends a move to the list.
+     * @param move The move to append.
+     */
+    void add(const int move)
+    {
+        assert(count < MAX_MOVES);
+        moves[count++] = move;
+    }
+
+    /**
+     * @brief Removes all moves from the list.
+     */
+    void clear() { count = 0; }
+
+    /**
+     * @brief Gets the number of moves in the list.
+     * @return The number of moves.
+     */
+    [[nodiscard]] int size() const { return count; }
+
+    /**
+     * @brief Checks if the list is empty.
+     * @return true if the list contains no move, false otherwise.
+     */
+    [[nodiscard]] bool empty() const { return count == 0; }
+
+    /**
+     * @brief Accesses a move of the list.
+     * @param index The position of the move in the list.
+     * @return A reference to the move.
+     */
+    int& operator[](const int index) { return moves[index]; }
+
+    /**
+     * @brief Accesses a move of the list.
+     * @param index The position of the move in the list.
+     * @return The move.
+     */
+    int operator[](const int index) const { return moves[index]; }
+
+    /**
+     * @brief Gets an iterator to the first move.
+     * @return A pointer to the first move.
+     */
+    int* begin() { return moves; }
+
+    /**
+     * @brief Gets an iterator past the last move.
+     * @return A pointer past the last move.
+     */
+    int* end() { return moves + count; }
+
+    /**
+     * @brief Gets an iterator to the first move.
+     * @return A pointer to the first move.
+     */
+    [[nodiscard]] const int* begin() const { return moves; }
+
+    /**
+     * @brief Gets an iterator past the last move.
+     * @return A pointer past the last move.
+     */
+    [[nodiscard]] const int* end() const { return moves + count; }
+};
+
+#endif //MOVELIST_H
@@ -0,0 +1,167 @@
+/**
+ * @file MoveOrderer.h
+ * @brief Declaration and implementation of the move ordering used by the search.
+ */
+
+#ifndef MOVEORDERER_H
+#define MOVEORDERER_H
+
+#include <MoveList.h>
+#include <SearchTraits.h>
+#include <algorithm>
+
+/**
+ * @class MoveOrderer
+ * @brief Sorts the moves of a node so that the moves most likely to cause a cutoff come first.
+ *
+ * Alpha-beta prunes the most when the best move is searched first. The moves are sorted by:
+ * 1. the best move stored in the transposition table for the position,
+ * 2. the killer moves of the ply, which recently caused a cutoff in a sibling position,
+ * 3. the history score of the move, accumulated over every cutoff it caused,
+ * 4. the static priority given by `SearchTraits<TGame>::movePriority` (e.g. center first for Connect 4).
+ * Equal moves keep the order in which the game generated them.
+ *
+ * The engine takes the orderer as a template parameter, so another strategy can be plugged in
+ * with the same interface.
+ * @tparam TGame The concrete game type.
+ */
+template <typename TGame>
+class MoveOrderer {
+private:
+    static constexpr int MAX_PLY = 256; ///< The deepest ply with killer moves.
+    static constexpr int KILLERS_PER_PLY = 2; ///< The number of killer moves kept per ply.
+    static constexpr int MAX_HISTORY = 1 << 20; ///< History scores are halved when one reaches this value.
+
+    int killers[MAX_PLY][KILLERS_PER_PLY]; ///< The last moves that caused a cutoff, per ply.
+    int history[2][MAX_MOVES]; ///< The history score of each move, for the maximizing (0) and minimizing (1) side.
+
+public:
+    /**
+     * @brief Constructs an orderer with no knowledge.
+     */
+    MoveOrderer();
+
+    /**
+     * @brief Prepares the orderer for a new search.
+     *
+     * The killer moves are forgotten, and the history scores are halved so that they favor recent searches.
+     */
+    void startSearch();
+
+    /**
+     * @brief Sorts the moves of a node, best candidates first.
+     * @param moves The moves to sort.
+     * @param ply The distance of the node from the root.
+     * @param ttMove The best move stored in the transposition table, or -1.
+     * @param isMaximizing Whether the player to move is maximizing the score.
+     */
+    void order(MoveList &moves, int ply, int ttMove, bool isMaximizing) const;
+
+    /**
+     * @brief Records a move that caused a cutoff.
+     * @param move The move.
+     * @param ply The distance of the node from the root.
+     * @param remainingDepth The depth that was left to search below the node.
+     * @param isMaximizing Whether the player to move is maximizing the score.
+     */
+    void recordCutoff(int move, int ply, int remainingDepth, bool isMaximizing);
+};
+
+/**
+ * @brief Constructs an orderer with no knowledge.
+ */
+template <typename TGame>
+MoveOrderer<TGame>::MoveOrderer() : history()
+{
+    startSearch();
+}
+
+/**
+ * @brief Prepares the orderer for a new search.
+ *
+ * The killer moves are forgotten, and the history scores are halved so that they favor recent searches.
+ */
+template <typename TGame>
+void MoveOrderer<TGame>::startSearch()
+{
+    for (auto& plyKillers : killers)
+    {
+        std::fill(std::begin(plyKillers), std::end(plyKillers), -1);
+    }
+    for (auto& sideHistory : history)
+    {
+        for (int& score : sideHistory) score /= 2;
+    }
+}
+
+/**
+ * @brief Sorts the moves of a node, best candidates first.
+ * @param moves The moves to sort.
+ * @param ply The distance of the node from the root.
+ * @param ttMove The best move stored in the transposition table, or -1.
+ * @param isMaximizing Whether the player to move is maximizing the score.
+ */
+template <typename TGame>
+void MoveOrderer<TGame>::order(MoveList &moves, const int ply, const int ttMove, const bool isMaximizing) const
+{
+    constexpr int TT_MOVE_SCORE = 1 << 30;
+    constexpr int KILLER_SCORE = 1 << 28;
+
+    const int* plyKillers = ply < MAX_PLY ? killers[ply] : nullptr;
+    const int* sideHistory = history[isMaximizing ? 0 : 1];
+
+    int scores[MAX_MOVES];
+    for (int i = 0; i < moves.size(); ++i)
+    {
+        const int move = moves[i];
+        // History scores are below MAX_HISTORY, the static priority only breaks their ties.
+        int score = sideHistory[move] * 64 + SearchTraits<TGame>::movePriority(move);
+        if (move == ttMove) score = TT_MOVE_SCORE;
+        else if (plyKillers && move == plyKillers[0]) score = KILLER_SCORE + 1;
+        else if (plyKillers && move == plyKillers[1]) score = KILLER_SCORE;
+        scores[i] = score;
+    }
+
+    // Insertion sort: the lists are short, and the sort is stable.
+    for (int i = 1; i < moves.size(); ++i)
+    {
+        const int move = moves[i];
+        const int score = scores[i];
+        int j = i;
+        for (; j > 0 && scores[j - 1] < score; --j)
+        {
+            moves[j] = moves[j - 1];
+            scores[j] = scores[j - 1];
+        }
+        moves[j] = move;
+        scores[j] = score;
+    }
+}
+
+/**
+ * @brief Records a move that caused a cutoff.
+ * @param move The move.
+ * @param ply The distance of the node from the root.
+ * @param remainingDepth The depth that was left to search below the node.
+ * @param isMaximizing Whether the player to move is maximizing the score.
+ */
+template <typename TGame>
+void MoveOrderer<TGame>::recordCutoff(const int move, const int ply, const int remainingDepth, const bool isMaximizing)
+{
+    if (ply < MAX_PLY && killers[ply][0] != move)
+    {
+        killers[ply][1] = killers[ply][0];
+        killers[ply][0] = move;
+    }
+
+    // Cutoffs close to the root save the most work, so they weigh the most.
+    int (&sideHistory)[MAX_MOVES] = history[isMaximizing ? 0 : 1];
+    const int bonus = std::min(remainingDepth, 64);
+    sideHistory[move] += bonus * bonus;
+    if (sideHistory[move] >= MAX_HISTORY)
+    {
+        for (int& score : sideHistory) score /= 2;
+    }
+}
+
+#endif //MOVEORDERER_H
@@ -0,0 +1,144 @@
+/**
+ * @file OpeningBook.h
+ * @brief Declaration of the OpeningBook class, a read-only table of precomputed opening moves.
+ */
+
+#ifndef OPENINGBOOK_H
+#define OPENINGBOOK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @struct BookEntry
+ * @brief The precomputed result of one position.
+ */
+struct BookEntry {
+    uint64_t key = 0;  ///< The canonical hash of the position, see Game::getCanonicalHash().
+    int16_t score = 0; ///< The score of the position.
+    int16_t move = -1; ///< The best move of the canonical image of the position.
+};
+
+/**
+ * @enum BookFormat
+ * @brief The layouts of a book file.
+ */
+enum class BookFormat : uint32_t {
+    Flat = 1,      ///< Fixed-size records, searched directly.
+    Compressed = 2 ///< Blocks of delta-encoded records, found through a block index.
+};
+
+/**
+ * @class OpeningBook
+ * @brief Table of precomputed best moves, read from a memory-mapped file.
+ *
+ * The file starts with a header (magic, format version, number of records), followed by the
+ * records sorted by position hash. Either format is searched directly in the mapped pages:
+ * - Flat: fixed-size records, found by binary search.
+ * - Compressed: the records are cut into blocks, each storing its keys as varint deltas from the
+ *   previous one. A block index holding the first key and the offset of each block is searched by
+ *   binary search, then a single block is decoded.
+ *
+ * A position and its mirror image share one record. A book written before the records were
+ * keyed by the canonical hash still works: the record of the canonical image was there too.
+ *
+ * Nothing is parsed or copied when the book is opened, which keeps startup fast, and processes
+ * opening the same book share its pages. Numbers are stored in the byte order of the machine that
+ * wrote them.
+ */
+class OpeningBook final {
+private:
+    const unsigned char* data = nullptr; ///< The mapped file, nullptr when no book is open.
+    std::size_t dataSize = 0; ///< The size of the mapped file, in bytes.
+    std::size_t recordCount = 0; ///< The number of records in the book.
+    BookFormat format = BookFormat::Flat; ///< The layout of the open book.
+    std::size_t blockCount = 0; ///< The number of blocks of a compressed book.
+    std::vector<unsigned char> buffer; ///< The content of the file on systems without mmap.
+
+    /**
+     * @brief Checks the header of the mapped file, and closes the book if it is invalid.
+     * @return true if the file is a valid book, false otherwise.
+     */
+    bool validate();
+
+    /**
+     * @brief Looks up a position in a flat book.
+     * @param key The Zobrist hash of the position.
+     * @param entry Receives the record of the position when it is found.
+     * @return true if the position is in the book, false otherwise.
+     */
+    bool probeFlat(uint64_t key, BookEntry &entry) const;
+
+    /**
+     * @brief Looks up a position in a compressed book.
+     * @param key The Zobrist hash of the position.
+     * @param entry Receives the record of the position when it is found.
+     * @return true if the position is in the book, false otherwise.
+     */
+    bool probeCompressed(uint64_t key, BookEntry &entry) const;
+
+public:
+    /**
+     * @brief Constructs a closed book, which contains no position.
+     */
+    OpeningBook() = default;
+
+    /**
+     * @brief Constructs a book and opens a file.
+     * @param path The path of the book file. Check isOpen() to know whether it could be opened.
+     */
+    explicit OpeningBook(const std::string &path);
+
+    OpeningBook(const OpeningBook &) = delete;
+    OpeningBook &operator=(const OpeningBook &) = delete;
+
+    /**
+     * @brief Unmaps the file.
+     */
+    ~OpeningBook();
+
+    /**
+     * @brief Maps a book file, replacing the book currently open.
+     * @param path The path of the book file.
+     * @return true if the file is a valid book, false otherwise.
+     */
+    bool open(const std::string &path);
+
+    /**
+     * @brief Unmaps the file. The book then contains no position.
+     */
+    void close();
+
+    /**
+     * @brief Checks whether a book is open.
+     * @return true if a valid book file is mapped, false otherwise.
+     */
+    [[nodiscard]] bool isOpen() const;
+
+    /**
+     * @brief Gets the number of positions in the book.
+     * @return The number of records.
+     */
+    [[nodiscard]] std::size_t size() const;
+
+    /**
+     * @brief Looks up a position.
+     * @param key The Zobrist hash of the position.
+     * @param entry Receives the record of the position when it is found.
+     * @return true if the position is in the book, false otherwise.
+     */
+    bool probe(uint64_t key, BookEntry &entry) const;
+
+    /**
+     * @brief Writes a book file.
+     * @param path The path of the file to create.
+     * @param entries The positions of the book, in any order. Only the first record of a hash is kept.
+     * @param format The layout of the file.
+     * @return true if the file was written, false otherwise.
+     */
+    static bool write(const std::string &path, std::vector<BookEntry> entries, BookFormat format = BookFormat::Compressed);
+};
+
+#endif //OPENINGBOOK_H
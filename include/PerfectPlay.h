@@ -0,0 +1,165 @@
+/**
+ * @file PerfectPlay.h
+ * @brief Declaration and implementation of the perfect-play table of small games.
+ */
+
+#ifndef PERFECTPLAY_H
+#define PERFECTPLAY_H
+
+#include <MoveList.h>
+#include <cstdint>
+#include <unordered_map>
+
+/**
+ * @class PerfectPlay
+ * @brief Table of the best move and exact score of every position of a small game.
+ *
+ * The table is generated once, when it is constructed, by solving every position reachable from
+ * the initial one. Each position is solved only once, however many move orders reach it, so the
+ * whole of Tic-Tac-Toe takes a few thousand positions. Afterwards, the move of the AI is a single
+ * lookup by Zobrist hash instead of a search.
+ *
+ * The scores are those of the alpha-beta search: the AI maximizes the evaluation and the player
+ * minimizes it. Ties are broken in favor of the first move generated by the game.
+ * @tparam TGame The concrete game type. Its tree must fit in memory.
+ */
+template <typename TGame>
+class PerfectPlay {
+private:
+    /**
+     * @struct Entry
+     * @brief The solution of one position.
+     */
+    struct Entry {
+        int16_t move;  ///< The best move, or -1 if the game is over.
+        int16_t score; ///< The exact score of the position.
+    };
+
+    std::unordered_map<uint64_t, Entry> entries; ///< The solution of each position, by Zobrist hash.
+
+    /**
+     * @brief Solves a position and every position reachable from it.
+     * @param game The position to solve. It is restored before returning.
+     * @return The exact score of the position.
+     */
+    int solve(TGame &game);
+
+public:
+    /**
+     * @brief Generates the table of every position reachable from a game.
+     * @param initial The position to start from, usually the initial position of the game.
+     */
+    explicit PerfectPlay(const TGame &initial);
+
+    /**
+     * @brief Gets the best move of a position.
+     * @param game The position.
+     * @return The best move, or -1 if the position is over or not in the table.
+     */
+    [[nodiscard]] int getBestMove(const TGame &game) const;
+
+    /**
+     * @brief Gets the exact score of a position.
+     * @param game The position.
+     * @param score Receives the score when the position is in the table.
+     * @return true if the position is in the table, false otherwise.
+     */
+    bool getScore(const TGame &game, int &score) const;
+
+    /**
+     * @brief Gets the number of positions in the table.
+     * @return The number of positions solved.
+     */
+    [[nodiscard]] std::size_t size() const;
+};
+
+/**
+ * @brief Generates the table of every position reachable from a game.
+ * @param initial The position to start from, usually the initial position of the game.
+ */
+template <typename TGame>
+PerfectPlay<TGame>::PerfectPlay(const TGame &initial)
+{
+    TGame game = initial;
+    (void) solve(game);
+}
+
+/**
+ * @brief Solves a position and every position reachable from it.
+ * @param game The position to solve. It is restored before returning.
+ * @return The exact score of the position.
+ */
+template <typename TGame>
+int PerfectPlay<TGame>::solve(TGame &game)
+{
+    const uint64_t key = game.getHash();
+    if (const auto found = entries.find(key); found != entries.end()) return found->second.score;
+
+    if (game.isTerminal())
+    {
+        const int score = game.evaluate();
+        entries.emplace(key, Entry{-1, static_cast<int16_t>(score)});
+        return score;
+    }
+
+    const bool isMaximizing = game.getCurrentPlayer() == game.AI;
+    int bestScore = 0;
+    int bestMove = -1;
+
+    MoveList moves;
+    game.generateMoves(moves);
+    for (const auto move : moves)
+    {
+        game.makeMove(move);
+        const int score = solve(game);
+        game.undoMove(move);
+
+        if (bestMove == -1 || (isMaximizing ? score > bestScore : score < bestScore))
+        {
+            bestScore = score;
+            bestMove = move;
+        }
+    }
+
+    entries.emplace(key, Entry{static_cast<int16_t>(bestMove), static_cast<int16_t>(bestScore)});
+    return bestScore;
+}
+
+/**
+ * @brief Gets the best move of a position.
+ * @param game The position.
+ * @return The best move, or -1 if the position is over or not in the table.
+ */
+template <typename TGame>
+int PerfectPlay<TGame>::getBestMove(const TGame &game) const
+{
+    const auto found = entries.find(game.getHash());
+    return found != entries.end() ? found->second.move : -1;
+}
+
+/**
+ * @brief Gets the exact score of a position.
+ * @param game The position.
+ * @param score Receives the score when the position is in the table.
+ * @return true if the position is in the table, false otherwise.
+ */
+template <typename TGame>
+bool PerfectPlay<TGame>::getScore(const TGame &game, int &score) const
+{
+    const auto found = entries.find(game.getHash());
+    if (found == entries.end()) return false;
+    score = found->second.score;
+    return true;
+}
+
+/**
+ * @brief Gets the number of positions in the table.
+ * @return The number of positions solved.
+ */
+template <typename TGame>
+std::size_t PerfectPlay<TGame>::size() const
+{
+    return entries.size();
+}
+
+#endif //PERFECTPLAY_H
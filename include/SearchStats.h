@@ -0,0 +1,73 @@
+/**
+ * @file SearchStats.h
+ * @brief Declaration of the statistics collected by the search.
+ */
+
+#ifndef SEARCHSTATS_H
+#define SEARCHSTATS_H
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#ifndef MINMAX_SEARCH_STATS
+#define MINMAX_SEARCH_STATS 1 ///< Set to 0 to compile the collection of statistics out of the search.
+#endif
+
+/// Whether the search collects the counters of `SearchStats`. When false, they stay 0 and cost nothing.
+inline constexpr bool SEARCH_STATS_ENABLED = MINMAX_SEARCH_STATS != 0;
+
+/**
+ * @struct RootMoveScore
+ * @brief The score of one root move in the deepest completed iteration.
+ */
+struct RootMoveScore {
+    int move;  ///< The root move.
+    int score; ///< Its score. Only the score of the best move is exact, the others may be bounds.
+};
+
+/**
+ * @struct SearchStats
+ * @brief The work done by one search, summed over all its threads.
+ *
+ * The node count and elapsed time are always measured. The other counters are only collected
+ * when `SEARCH_STATS_ENABLED` is true.
+ */
+struct SearchStats {
+    long long nodes = 0;           ///< The number of nodes visited.
+    long long leafEvaluations = 0; ///< The number of positions scored by `evaluate()`.
+    long long cutoffs = 0;         ///< The number of nodes whose remaining moves were pruned.
+    long long ttProbes = 0;        ///< The number of transposition table lookups.
+    long long ttHits = 0;          ///< The number of lookups that found their position.
+    int maxDepth = 0;              ///< The deepest node visited, in plies below the root move.
+    std::chrono::microseconds elapsed{0}; ///< The wall-clock time of the search.
+    std::vector<RootMoveScore> rootScores; ///< The scores of the root moves, in the order they were searched.
+
+    /**
+     * @brief Adds the counters of a search run by another thread.
+     * @param other The statistics of the other search. Its time and root scores are ignored.
+     */
+    void merge(const SearchStats &other)
+    {
+        nodes += other.nodes;
+        leafEvaluations += other.leafEvaluations;
+        cutoffs += other.cutoffs;
+        ttProbes += other.ttProbes;
+        ttHits += other.ttHits;
+        maxDepth = std::max(maxDepth, other.maxDepth);
+    }
+};
+
+/**
+ * @struct SearchResult
+ * @brief The outcome of one search.
+ */
+struct SearchResult {
+    int move = -1;  ///< The best move, or -1 if there is no move available.
+    int score = 0;  ///< The score of the best move.
+    int depth = -1; ///< The depth of the deepest completed iteration, or -1 if the move came from the book.
+    SearchStats stats; ///< The work done by the search.
+    std::vector<int> principalVariation; ///< The expected line of play, starting with the best move.
+};
+
+#endif //SEARCHSTATS_H
@@ -0,0 +1,136 @@
+/**
+ * @file SearchTraits.h
+ * @brief Compile-time search parameters of each game.
+ */
+
+#ifndef SEARCHTRAITS_H
+#define SEARCHTRAITS_H
+
+#include <Connect4.h>
+#include <SticksGame.h>
+#include <TicTacToe.h>
+#include <algorithm>
+#include <chrono>
+
+/**
+ * @struct SearchTraits
+ * @brief Search parameters of a game, resolved at compile time.
+ *
+ * The primary template describes a game small enough to be searched until the end.
+ * Games needing other parameters specialize it.
+ * @tparam TGame The concrete game type.
+ */
+template <typename TGame>
+struct SearchTraits {
+    static constexpr int maxDepth = 999999; ///< The depth limit of the search below the root move.
+    static constexpr int minScore = -10;    ///< The lowest score `evaluate()` can return.
+    static constexpr int maxScore = 10;     ///< The highest score `evaluate()` can return.
+    static constexpr std::chrono::milliseconds timeBudget{0}; ///< The time allowed per move, 0 for no limit.
+    static constexpr int aspirationWindow = 0; ///< Half the root window around the previous score, 0 for a full window.
+
+    /**
+     * @brief Gets the static priority of a move, used to order moves the search knows nothing about.
+     * @param move The move.
+     * @return The priority, higher first, between -32 and 31.
+     */
+    static constexpr int movePriority(int) { return 0; }
+};
+
+/**
+ * @brief Search parameters of Connect 4, for every board size.
+ *
+ * The tree is too large to be searched until the end, so the search deepens until its time
+ * budget per move runs out.
+ */
+template <int W, int H, int N>
+struct SearchTraits<BasicConnect4<W, H, N>> {
+    static constexpr int maxDepth = W * H; ///< The depth limit of the search below the root move.
+    static constexpr int minScore = -BasicConnect4<W, H, N>::WIN_SCORE; ///< The lowest score `evaluate()` can return.
+    static constexpr int maxScore = BasicConnect4<W, H, N>::WIN_SCORE;  ///< The highest score `evaluate()` can return.
+    static constexpr std::chrono::milliseconds timeBudget{50}; ///< The time allowed per move, 0 for no limit.
+    static constexpr int aspirationWindow = 16; ///< Half the root window around the previous score, 0 for a full window.
+
+    /**
+     * @brief Gets the static priority of a move, used to order moves the search knows nothing about.
+     *
+     * A piece in a central column belongs to more alignments, so the columns are tried from the center outwards.
+     * @param move The column of the move.
+     * @return The priority, higher first, between -32 and 31.
+     */
+    static constexpr int movePriority(const int move)
+    {
+        const int distance = move < W / 2 ? W / 2 - move : move - W / 2;
+        return -std::min(distance, 32);
+    }
+};
+
+/**
+ * @brief Search parameters of Tic-Tac-Toe.
+ *
+ * The classic board is searched until the end well within the time budget; larger boards
+ * deepen until it runs out.
+ */
+template <>
+struct SearchTraits<TicTacToe> {
+    static constexpr int maxDepth = MAX_CELLS; ///< The depth limit of the search below the root move.
+    static constexpr int minScore = -TicTacToe::WIN_SCORE; ///< The lowest score `evaluate()` can return.
+    static constexpr int maxScore = TicTacToe::WIN_SCORE;  ///< The highest score `evaluate()` can return.
+    static constexpr std::chrono::milliseconds timeBudget{1000}; ///< The time allowed per move, 0 for no limit.
+    static constexpr int aspirationWindow = 32; ///< Half the root window around the previous score, 0 for a full window.
+
+    /**
+     * @brief Gets the static priority of a move, used to order moves the search knows nothing about.
+     * @param move The move.
+     * @return The priority, higher first, between -32 and 31.
+     */
+    static constexpr int movePriority(int) { return 0; }
+};
+
+/**
+ * @enum ParallelMode
+ * @brief How a search with several threads shares the work.
+ */
+enum class ParallelMode {
+    RootSplit, ///< The root moves are dealt to the threads. Deterministic, but limited by the number of root moves.
+    LazySmp    ///< Every thread searches the whole tree, sharing one transposition table.
+};
+
+/**
+ * @enum SearchEngine
+ * @brief The algorithm choosing the moves of the AI.
+ */
+enum class SearchEngine {
+    AlphaBeta, ///< Iterative deepening alpha-beta search, scoring the leaves with `evaluate()`. See `AlphaBeta`.
+    Mcts       ///< Monte Carlo tree search, scoring the leaves with random playouts. See `Mcts`.
+};
+
+/**
+ * @struct SearchLimits
+ * @brief Runtime limits of one search.
+ */
+struct SearchLimits {
+    int maxDepth = 0; ///< The deepest iteration, counted in plies below the root move.
+    std::chrono::milliseconds timeBudget{0}; ///< The time allowed for the search, 0 for no limit.
+    int threads = 1; ///< The number of threads searching in parallel.
+    ParallelMode parallelMode = ParallelMode::LazySmp; ///< How the threads share the work.
+    bool principalVariationSearch = true; ///< Whether the moves after the first are searched with a null window first.
+    bool aspirationWindows = true; ///< Whether each iteration starts with a narrow window around the previous score.
+    bool symmetries = true; ///< Whether symmetric positions share their table entries and symmetric root moves are searched once.
+    long long playouts = 0; ///< The number of playouts of a Monte Carlo search, 0 for no limit besides the time budget.
+
+    /**
+     * @brief Gets the default limits of a game.
+     * @tparam TGame The concrete game type.
+     * @return The limits given by `SearchTraits<TGame>`.
+     */
+    template <typename TGame>
+    static constexpr SearchLimits defaults()
+    {
+        SearchLimits limits;
+        limits.maxDepth = SearchTraits<TGame>::maxDepth;
+        limits.timeBudget = SearchTraits<TGame>::timeBudget;
+        return limits;
+    }
+};
+
+#endif //SEARCHTRAITS_H
@@ -0,0 +1,150 @@
+/**
+ * @file SelfPlay.h
+ * @brief Declaration and implementation of headless games between the AI and an opponent.
+ */
+
+#ifndef SELFPLAY_H
+#define SELFPLAY_H
+
+#include <AlphaBeta.h>
+#include <Mcts.h>
+#include <MoveList.h>
+#include <SearchTraits.h>
+#include <ThreadPool.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <vector>
+
+/**
+ * @enum Opponent
+ * @brief Who plays the PLAYER side of self-play games.
+ */
+enum class Opponent {
+    Engine, ///< The alpha-beta search, the same as the AI unless the AI uses another engine.
+    Random  ///< A uniformly random legal move.
+};
+
+/**
+ * @struct SelfPlayOptions
+ * @brief The settings of a batch of self-play games.
+ */
+struct SelfPlayOptions {
+    int games = 100; ///< The number of games to play.
+    int threads = 1; ///< The number of games played in parallel, each searching on one thread.
+    Opponent opponent = Opponent::Engine; ///< Who plays against the AI.
+    SearchEngine engine = SearchEngine::AlphaBeta; ///< The algorithm of the AI.
+    int randomOpeningPlies = 2; ///< The number of random moves starting each game, so that games differ.
+    std::size_t ttSizeMb = DEFAULT_TT_SIZE_MB; ///< The size of the transposition table of each thread, in MiB.
+    uint64_t seed = 1; ///< The seed of the random moves. Game i always uses the same random moves.
+};
+
+/**
+ * @struct SelfPlayReport
+ * @brief The aggregate results of a batch of self-play games.
+ */
+struct SelfPlayReport {
+    int games = 0;       ///< The number of games played.
+    int aiWins = 0;      ///< The number of games won by the AI.
+    int opponentWins = 0; ///< The number of games won by the opponent.
+    int draws = 0;       ///< The number of drawn games.
+    long long moves = 0; ///< The number of moves played, by both sides.
+    double seconds = 0;  ///< The wall-clock time of the batch.
+
+    /**
+     * @brief Gets the throughput of the batch.
+     * @return The number of moves played per second, by all threads.
+     */
+    [[nodiscard]] double movesPerSecond() const
+    {
+        return seconds > 0 ? moves / seconds : 0;
+    }
+};
+
+/**
+ * @brief Plays a batch of games between the AI and an opponent, without any input or output.
+ *
+ * The games are dealt to a thread pool. Each thread has its own engine, kept for all its games.
+ * The PLAYER side starts every other game. Each game begins with a few random moves, drawn from a
+ * generator seeded by the seed and the index of the game, so that the engine does not play the
+ * same game over and over. With the Monte Carlo engine, each thread also has its own tree, and
+ * the AI plays against the alpha-beta search when the opponent is the engine.
+ * @tparam TGame The concrete game type.
+ * @tparam TFactory A callable taking `bool userIsStarting` and returning a new game.
+ * @param makeGame Creates the game in its initial state.
+ * @param options The settings of the batch.
+ * @param limits The limits of each search of the AI, and of the opponent if it is the engine.
+ * @return The aggregate results.
+ */
+template <typename TGame, typename TFactory>
+SelfPlayReport runSelfPlay(TFactory makeGame, const SelfPlayOptions &options,
+                           SearchLimits limits = SearchLimits::defaults<TGame>())
+{
+    limits.threads = 1; // The threads play games in parallel instead.
+
+    SelfPlayReport report;
+    std::mutex reportMutex;
+    std::atomic<int> nextGame{0};
+
+    const auto playGames = [&]
+    {
+        AlphaBeta<TGame> engine(options.ttSizeMb);
+        std::optional<Mcts<TGame>> mcts;
+        if (options.engine == SearchEngine::Mcts) mcts.emplace(DEFAULT_TREE_SIZE_MB, options.seed);
+        SelfPlayReport local;
+        MoveList moves;
+
+        for (int index = nextGame++; index < options.games; index = nextGame++)
+        {
+            TGame game = makeGame(index % 2 == 0);
+            std::mt19937_64 random(options.seed + static_cast<uint64_t>(index));
+
+            for (int ply = 0; !game.isTerminal(); ++ply)
+            {
+                int move;
+                if (ply < options.randomOpeningPlies
+                    || (options.opponent == Opponent::Random && game.getCurrentPlayer() == game.PLAYER))
+                {
+                    game.generateMoves(moves);
+                    move = moves[std::uniform_int_distribution<int>(0, moves.size() - 1)(random)];
+                }
+                else if (mcts && game.getCurrentPlayer() == game.AI) move = mcts->getBestMove(game, limits);
+                else move = engine.getBestMove(game, limits);
+
+                game.makeMove(move);
+                ++local.moves;
+            }
+
+            const int winner = game.getWinner();
+            if (winner == game.AI) ++local.aiWins;
+            else if (winner == game.PLAYER) ++local.opponentWins;
+            else ++local.draws;
+            ++local.games;
+        }
+
+        std::lock_guard lock(reportMutex);
+        report.games += local.games;
+        report.aiWins += local.aiWins;
+        report.opponentWins += local.opponentWins;
+        report.draws += local.draws;
+        report.moves += local.moves;
+    };
+
+    const auto start = std::chrono::steady_clock::now();
+    {
+        const int threads = std::max(1, std::min(options.threads, options.games));
+        ThreadPool pool(threads);
+        std::vector<std::future<void>> workers;
+        for (int i = 0; i < threads; ++i) workers.push_back(pool.submit(playGames));
+        for (auto &worker : workers) worker.get();
+    }
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return report;
+}
+
+#endif //SELFPLAY_H
@@ -8,71 +8,114 @@
 
 #include <Game.h>
 #include <iostream>
+#include <optional>
+#include <string>
+#include <type_traits>
 #include <vector>
 
-constexpr int STICKS_NUMBER = 21; ///< The initial number of sticks on the board.
+constexpr int STICKS_NUMBER = 21; ///< The default initial number of sticks on the board.
+constexpr int MAX_TAKE = 3; ///< The default maximum number of sticks taken in one move.
+constexpr int MAX_TAKE_LIMIT = MAX_MOVES - 1; ///< The largest maximum take: a move indexes tables of `MAX_MOVES` entries.
 
 /**
  * @class SticksGame
  * @brief Represents a stick-picking game where players alternate removing 1-3 sticks until none remain.
  *
- * This class is a concrete implementation of the abstract `Game` class. It handles the game's rules,
- * state transitions, and evaluation logic.
+ * The player taking the last stick loses. The initial number of sticks and the maximum number of
+ * sticks taken per move can be chosen when the game is constructed.
+ *
+ * This class is a `PlayableGame`, played through the `Game` interface by GameAdapter. It handles the
+ * game's rules, state transitions, and evaluation logic. Its state is a few integers, trivially
+ * copyable.
  */
-class SticksGame final : public Game{
+class SticksGame final : public Players {
 private:
     int currentPlayer; ///< The current player (PLAYER or AI).
     int remainingSticks; ///< The number of sticks remaining in the game.
+    int maxTake; ///< The maximum number of sticks removed in one move.
+    uint64_t hash; ///< Zobrist hash of the remaining sticks, of the maximum take and of the player to move.
 
 public:
     /**
      * @brief Constructs a SticksGame instance.
      * @param userIsStarting Determines whether the user starts the game. Defaults to `true`.
+     * @param sticks The initial number of sticks, at least 1.
+     * @param maxTake The maximum number of sticks removed in one move, between 1 and `MAX_TAKE_LIMIT`.
+     * @throws std::invalid_argument If a parameter is out of range.
+     */
+    explicit SticksGame(bool userIsStarting = true, int sticks = STICKS_NUMBER, int maxTake = MAX_TAKE);
+
+    /**
+     * @brief Gets the number of sticks remaining in the game.
+     * @return The number of remaining sticks.
+     */
+    [[nodiscard]] int getRemainingSticks() const;
+
+    /**
+     * @brief Gets the maximum number of sticks removed in one move.
+     * @return The maximum take.
+     */
+    [[nodiscard]] int getMaxTake() const;
+
+    /**
+     * @brief Gets the parameters of the game not given by its type, shared by the positions of the same variant.
+     * @return The maximum take. The other positions of the game only have fewer sticks.
      */
-    explicit SticksGame(const bool userIsStarting = true)
-        : currentPlayer(userIsStarting ? PLAYER : AI), remainingSticks(STICKS_NUMBER) {}
+    [[nodiscard]] std::string getVariant() const;
 
     /**
      * @brief Gets the current player in the game.
      * @return An integer representing the current player (AI or PLAYER).
      */
-    [[nodiscard]] int getCurrentPlayer() const override;
+    [[nodiscard]] int getCurrentPlayer() const;
 
     /**
      * @brief Displays the current state of the Sticks Game.
      */
-    void display() const override;
+    void display() const;
 
     /**
      * @brief Checks if the game is in a terminal state.
      * @return true if the game is over (no sticks remaining), false otherwise.
      */
-    [[nodiscard]] bool isTerminal() const override;
+    [[nodiscard]] bool isTerminal() const;
 
     /**
      * @brief Gets all the valid moves available in the current game state.
-     * @return A vector of integers representing the number of sticks that can be removed (1, 2, or 3).
+     * @return A vector of integers representing the number of sticks that can be removed (1 to the maximum take).
      */
-    [[nodiscard]] std::vector<int> getAvailableMoves() const override;
+    [[nodiscard]] std::vector<int> getAvailableMoves() const;
+
+    /**
+     * @brief Writes all the valid moves into a move list.
+     * @param moves The list to fill with the numbers of sticks that can be removed (1 to the maximum take).
+     */
+    void generateMoves(MoveList &moves) const;
+
+    /**
+     * @brief Checks if at least one stick remains.
+     * @return true if a move can be made, false otherwise.
+     */
+    [[nodiscard]] bool hasMoves() const;
 
     /**
      * @brief Makes a move by removing a specified number of sticks.
      * @param numSticks The number of sticks to remove.
      */
-    void makeMove(int numSticks) override;
+    void makeMove(int numSticks);
 
     /**
      * @brief Undoes a move by restoring the specified number of sticks.
      * @param numSticks The number of sticks to restore.
      */
-    void undoMove(int numSticks) override;
+    void undoMove(int numSticks);
 
     /**
      * @brief Evaluates the current game state to calculate a score.
      * @return A score based on the evaluation:
      *         -10 if the current player loses, 10 if the current player wins, 0 otherwise.
      */
-    [[nodiscard]] int evaluate() const override;
+    [[nodiscard]] int evaluate() const;
 
     /**
      * @brief Determines the winner of the game.
@@ -81,22 +124,62 @@ public:
      *         - AI if the AI wins,
      *         - 0 if there is no winner yet.
      */
-    [[nodiscard]] int getWinner() const override;
+    [[nodiscard]] int getWinner() const;
+
+    /**
+     * @brief Gets the Zobrist hash of the current game state.
+     * @return A 64-bit hash of the remaining sticks, of the maximum take and of the player to move.
+     */
+    [[nodiscard]] uint64_t getHash() const;
+
+    /**
+     * @brief Gets the hash shared by the symmetric positions. The game has no symmetry.
+     * @return The hash of the game state.
+     */
+    [[nodiscard]] uint64_t getCanonicalHash() const;
+
+    /**
+     * @brief Maps a move to the canonical image of the position, the position itself.
+     * @param move The move.
+     * @return The same move.
+     */
+    [[nodiscard]] int toCanonicalMove(int move) const;
+
+    /**
+     * @brief Maps a move of the canonical image back to the position, the position itself.
+     * @param move The move.
+     * @return The same move.
+     */
+    [[nodiscard]] int fromCanonicalMove(int move) const;
+
+    /**
+     * @brief Encodes the game state as a line of text.
+     * @return The remaining sticks, the player to move and the maximum take.
+     */
+    [[nodiscard]] std::string toString() const;
+
+    /**
+     * @brief Decodes a game state encoded by toString().
+     * @param text The encoding: the number of remaining sticks, then the player to move, `X` or
+     *             `O`, then the maximum number of sticks taken per move. For instance `21 X 3`.
+     * @return The game, or nothing if the text is not a valid game state.
+     */
+    [[nodiscard]] static std::optional<SticksGame> fromString(const std::string &text);
 
     /**
      * @brief Checks if the player's input is valid.
      * @param input The number of sticks the player wants to pick.
-     * @return true if the input is valid (1-3 sticks and within remaining sticks), false otherwise.
+     * @return true if the input is valid (1 to the maximum take and within remaining sticks), false otherwise.
      */
-    [[nodiscard]] bool checkInput(int input) const override;
+    [[nodiscard]] bool checkInput(int input) const;
 
     /**
      * @brief Prompts the player to input the number of sticks they want to pick.
      * @return The number of sticks the player chooses to pick.
      */
-    [[nodiscard]] int askInput() const override;
+    [[nodiscard]] int askInput() const;
 };
 
-
+static_assert(std::is_trivially_copyable_v<SticksGame>, "The searches copy the Sticks game instead of undoing moves.");
 
 #endif //STICKSGAME_H
@@ -0,0 +1,52 @@
+/**
+ * @file SticksSolver.h
+ * @brief Declaration of the SticksSolver class, solving the Sticks game by dynamic programming.
+ */
+
+#ifndef STICKSSOLVER_H
+#define STICKSSOLVER_H
+
+#include <SticksGame.h>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class SticksSolver
+ * @brief Table of the winning move of every stick count of a Sticks game.
+ *
+ * The state of the game is only the number of remaining sticks, and the player taking the last
+ * stick loses. A count is won for the player to move when one of its moves leaves a count lost for
+ * the opponent, so the counts are solved from 0 upwards, each from the at most `maxTake` counts
+ * below it. The whole table takes O(n·k) time and O(n) memory, after which a move is a lookup.
+ */
+class SticksSolver final {
+private:
+    int maxTake; ///< The maximum number of sticks removed in one move.
+    std::vector<uint16_t> winningTake; ///< The take winning each count, 0 when the count is lost.
+
+public:
+    /**
+     * @brief Solves every stick count up to a maximum.
+     * @param maxSticks The largest number of sticks to solve.
+     * @param maxTake The maximum number of sticks removed in one move, between 1 and `MAX_TAKE_LIMIT`.
+     */
+    SticksSolver(int maxSticks, int maxTake);
+
+    /**
+     * @brief Checks whether the player to move wins with perfect play.
+     * @param sticks The number of remaining sticks, at most the solved maximum.
+     * @return true if the player to move wins, false otherwise.
+     */
+    [[nodiscard]] bool isWinning(int sticks) const;
+
+    /**
+     * @brief Gets the best move of a game.
+     *
+     * In a lost position, the smallest take is returned, leaving the opponent the most chances to err.
+     * @param game The game. Its maximum take must be the one solved.
+     * @return The number of sticks to take, or -1 if the game is over or was not solved.
+     */
+    [[nodiscard]] int getBestMove(const SticksGame &game) const;
+};
+
+#endif //STICKSSOLVER_H
@@ -0,0 +1,90 @@
+/**
+ * @file ThreadPool.h
+ * @brief Declaration of a fixed-size pool of worker threads.
+ */
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @class ThreadPool
+ * @brief Runs submitted tasks on a fixed set of worker threads.
+ *
+ * Tasks are executed in submission order by the first idle worker. The destructor finishes the
+ * queued tasks before joining the workers.
+ */
+class ThreadPool {
+private:
+    std::vector<std::thread> workers; ///< The worker threads.
+    std::queue<std::function<void()>> tasks; ///< The tasks waiting for a worker.
+    std::mutex mutex; ///< Protects the task queue and the stopping flag.
+    std::condition_variable available; ///< Signaled when a task is queued or the pool stops.
+    bool stopping = false; ///< Whether the pool is being destroyed.
+
+    /**
+     * @brief Main loop of a worker thread: runs tasks until the pool stops.
+     */
+    void run();
+
+public:
+    /**
+     * @brief Starts the worker threads.
+     * @param threadCount The number of worker threads. At least one thread is started.
+     */
+    explicit ThreadPool(unsigned threadCount);
+
+    /**
+     * @brief Finishes the queued tasks and joins the worker threads.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Gets the number of worker threads.
+     * @return The number of worker threads.
+     */
+    [[nodiscard]] unsigned size() const;
+
+    /**
+     * @brief Queues a task.
+     * @tparam F The type of the task, a callable taking no argument.
+     * @param task The task to run on a worker thread.
+     * @return A future receiving the result of the task, or the exception it threw.
+     */
+    template <typename F>
+    std::future<std::invoke_result_t<F>> submit(F task);
+};
+
+/**
+ * @brief Queues a task.
+ * @tparam F The type of the task, a callable taking no argument.
+ * @param task The task to run on a worker thread.
+ * @return A future receiving the result of the task, or the exception it threw.
+ */
+template <typename F>
+std::future<std::invoke_result_t<F>> ThreadPool::submit(F task)
+{
+    // std::function requires a copyable callable, so the packaged task is shared.
+    auto packaged = std::make_shared<std::packaged_task<std::invoke_result_t<F>()>>(std::move(task));
+    auto result = packaged->get_future();
+    {
+        std::lock_guard lock(mutex);
+        tasks.emplace([packaged] { (*packaged)(); });
+    }
+    available.notify_one();
+    return result;
+}
+
+#endif //THREADPOOL_H
@@ -1,98 +1,329 @@
 /**
  * @file TicTacToe.h
- * @brief Declaration of the TicTacToe class, a concrete implementation of the Game interface.
+ * @brief Declaration of the TicTacToe class, a game state of the searches.
  */
 
 #ifndef TICTACTOE_H
 #define TICTACTOE_H
 
 #include <Game.h>
+#include <algorithm>
+#include <array>
+#include <bitset>
 #include <iostream>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <vector>
 
 
-constexpr int BOARD_SIZE = 3; ///< The size of the Tic-Tac-Toe board.
+constexpr int BOARD_SIZE = 3; ///< The default number of rows, columns and aligned markers of the Tic-Tac-Toe board.
+constexpr int MAX_CELLS = MAX_MOVES; ///< The largest number of cells of a board: every empty cell may be a move.
+constexpr int FULL_WIDTH_CELLS = 49; ///< Boards up to this number of cells consider every empty cell as a move.
+constexpr int CANDIDATE_DISTANCE = 2; ///< On larger boards, the moves are the empty cells this close to a marker.
+constexpr int MAX_SYMMETRIES = 8; ///< The number of symmetries of a square board: 4 rotations, each possibly mirrored.
+
+using Bitboard = std::bitset<MAX_CELLS>; ///< One bit per cell, indexed by `row * columns + column`.
+
+/**
+ * @brief Counts the lines of aligned cells of a board.
+ *
+ * A single cell is a line of one; longer lines run along the rows, the columns and both diagonals.
+ * @param rows The number of rows.
+ * @param columns The number of columns.
+ * @param alignment The number of cells of a line.
+ * @return The number of lines.
+ */
+constexpr int lineCountOf(const int rows, const int columns, const int alignment)
+{
+    if (alignment == 1) return rows * columns;
+    const int rowStarts = std::max(0, rows - alignment + 1);
+    const int columnStarts = std::max(0, columns - alignment + 1);
+    return rows * columnStarts + columns * rowStarts + 2 * rowStarts * columnStarts;
+}
+
+/**
+ * @brief Finds the largest number of lines of a board of at most `MAX_CELLS` cells.
+ *
+ * Lines of two cells are the most numerous, unless the board is a single row or column.
+ * @return The number of lines of the board having most.
+ */
+constexpr int maxLineCount()
+{
+    int most = MAX_CELLS;
+    for (int rows = 1; rows <= MAX_CELLS; ++rows)
+    {
+        for (int columns = 1; rows * columns <= MAX_CELLS; ++columns)
+        {
+            most = std::max(most, lineCountOf(rows, columns, 2));
+        }
+    }
+    return most;
+}
+
+constexpr int MAX_LINES = maxLineCount(); ///< The largest number of lines of a board, 930 on a 16x16 board with 2 in a row.
 
 /**
  * @class TicTacToe
  * @brief A class representing a Tic-Tac-Toe game.
  *
  * This class provides the game logic for Tic-Tac-Toe, including displaying the board,
- * making moves, undoing moves, and evaluating the game state. It extends the abstract `Game` class.
+ * making moves, undoing moves, and evaluating the game state. It is a `PlayableGame`, played
+ * through the `Game` interface by GameAdapter. Its masks depend on the size of the board, chosen
+ * at run time: they are computed once per size and never freed, and the game only points to
+ * them. The marker counts of the lines are arrays sized for the largest board, so the game is
+ * trivially copyable, and a copy does not allocate.
+ *
+ * A copy therefore moves about 2 KiB whatever the size of the board, mostly line counters a
+ * small board never uses. It is still a single memcpy, cheaper than the two allocations of
+ * counters sized to the board, and a Monte Carlo iteration copies the board once. The counters
+ * could only be sized to the board with a game type per board size, chosen at compile time.
+ *
+ * The board has any number of rows and columns (m,n,k-game), and the game is won by aligning k
+ * markers, so it also plays Gomoku-like variants such as 15x15 with 5 in a row. Each player's
+ * markers are a bitboard, and every line of k cells is precomputed, with the lines through each
+ * cell. A move only updates the marker counts of the lines through its cell, which keeps the
+ * winner and the evaluation up to date without scanning the board.
+ *
+ * The hash of the board is also maintained for its images by the symmetries of the board: the
+ * 8 rotations and reflections of a square board, or the 4 reflections of a rectangular one.
+ *
+ * Large boards cannot be searched until the end. Their moves are restricted to cells close to
+ * the markers already played, and evaluate() scores the lines still open to a single player.
  */
-class TicTacToe final : public Game {
+class TicTacToe final : public Players {
+public:
+    static constexpr int WIN_SCORE = 30000; ///< The score of a won game. No heuristic score reaches it.
+
 private:
-    int board[BOARD_SIZE][BOARD_SIZE]; ///< The Tic-Tac-Toe game board.
+    /**
+     * @struct Geometry
+     * @brief The precomputed masks of a board size, shared by every game of that size.
+     */
+    struct Geometry {
+        int rows; ///< The number of rows.
+        int columns; ///< The number of columns.
+        int alignment; ///< The number of aligned markers winning the game.
+        int lineCount; ///< The number of lines of `alignment` cells.
+        std::vector<std::vector<uint16_t>> cellLines; ///< The lines through each cell.
+        std::vector<Bitboard> neighborhoods; ///< The cells within `CANDIDATE_DISTANCE` of each cell.
+        int symmetryCount; ///< The number of symmetries of the board, identity included: 8 if square, 4 otherwise.
+        std::vector<uint16_t> images[MAX_SYMMETRIES]; ///< The image of each cell by each symmetry.
+        std::vector<uint16_t> preimages[MAX_SYMMETRIES]; ///< The cell whose image by each symmetry is each cell.
+    };
+
+    const Geometry* geometry; ///< The size of the board and its masks, see geometryOf().
+    Bitboard playerCells; ///< The cells holding a PLAYER marker.
+    Bitboard aiCells; ///< The cells holding an AI marker.
     int currentPlayer; ///< The ID of the current player (PLAYER or AI).
+    std::array<uint64_t, MAX_SYMMETRIES> hashes; ///< Zobrist hashes of the images of the board by its symmetries, the identity first, including the board size.
+    int filledCells = 0; ///< The number of cells holding a marker.
+    std::array<uint8_t, MAX_LINES> playerLineMarkers{}; ///< The number of PLAYER markers in each line.
+    std::array<uint8_t, MAX_LINES> aiLineMarkers{}; ///< The number of AI markers in each line.
+    int playerLines = 0; ///< The number of lines full of PLAYER markers.
+    int aiLines = 0; ///< The number of lines full of AI markers.
+    int lineScore = 0; ///< The sum of the scores of the lines open to a single player.
+
+    /**
+     * @brief Gets the number of cells of the board.
+     * @return The number of rows times the number of columns.
+     */
+    [[nodiscard]] int cellCount() const;
+
+    /**
+     * @brief Gets the masks of a board size, computed on its first use.
+     * @param rows The number of rows.
+     * @param columns The number of columns.
+     * @param alignment The number of aligned markers winning the game.
+     * @return The masks of the board, kept until the program exits.
+     */
+    static const Geometry* geometryOf(int rows, int columns, int alignment);
+
+    /**
+     * @brief Computes the masks of a board size.
+     * @param rows The number of rows.
+     * @param columns The number of columns.
+     * @param alignment The number of aligned markers winning the game.
+     * @return The masks of the board.
+     */
+    static Geometry makeGeometry(int rows, int columns, int alignment);
+
+    /**
+     * @brief Adds or removes a marker in the lines through a cell.
+     * @param cellIndex The cell of the marker.
+     * @param isPlayer Whether the marker belongs to PLAYER.
+     * @param delta 1 to add the marker, -1 to remove it.
+     */
+    void updateLines(int cellIndex, bool isPlayer, int delta);
+
+    /**
+     * @brief Toggles a marker in the hashes of the board and of its images.
+     * @param cellIndex The cell of the marker.
+     * @param isPlayer Whether the marker belongs to PLAYER.
+     */
+    void toggleHashes(int cellIndex, bool isPlayer);
+
+    /**
+     * @brief Finds the symmetry giving the canonical image of the board.
+     * @return The symmetry whose image has the smallest hash.
+     */
+    [[nodiscard]] int canonicalSymmetry() const;
 
 public:
     /**
      * @brief Constructs a TicTacToe game instance.
      * @param userIsStarting A boolean indicating if the user is the starting player.
+     * @param rows The number of rows, at least 1.
+     * @param columns The number of columns, at least 1. The board has at most `MAX_CELLS` cells.
+     * @param alignment The number of aligned markers winning the game, between 1 and the larger dimension.
+     * @throws std::invalid_argument If a parameter is out of range.
      */
-    explicit TicTacToe(bool userIsStarting = true);
+    explicit TicTacToe(bool userIsStarting = true, int rows = BOARD_SIZE, int columns = BOARD_SIZE,
+                       int alignment = BOARD_SIZE);
+
+    /**
+     * @brief Gets the number of rows of the board.
+     * @return The number of rows.
+     */
+    [[nodiscard]] int getRows() const;
+
+    /**
+     * @brief Gets the number of columns of the board.
+     * @return The number of columns.
+     */
+    [[nodiscard]] int getColumns() const;
+
+    /**
+     * @brief Gets the number of aligned markers winning the game.
+     * @return The length of a winning line.
+     */
+    [[nodiscard]] int getAlignment() const;
+
+    /**
+     * @brief Gets the parameters of the game not given by its type, shared by the positions of the same variant.
+     * @return The rows, columns and alignment, e.g. `3x3/3`.
+     */
+    [[nodiscard]] std::string getVariant() const;
 
     /**
      * @brief Gets the current player in the game.
      * @return An integer representing the current player (AI or PLAYER).
      */
-    [[nodiscard]] int getCurrentPlayer() const override;
+    [[nodiscard]] int getCurrentPlayer() const;
 
     /**
      * @brief Displays the current state of the Tic-Tac-Toe board.
      */
-    void display() const override;
+    void display() const;
 
     /**
      * @brief Checks if the game is in a terminal state (win, lose, or draw).
      * @return true if the game is over, false otherwise.
      */
-    [[nodiscard]] bool isTerminal() const override;
+    [[nodiscard]] bool isTerminal() const;
 
     /**
      * @brief Gets all the available moves on the current board.
      * @return A vector of integers representing the indices of empty cells.
      */
-    [[nodiscard]] std::vector<int> getAvailableMoves() const override;
+    [[nodiscard]] std::vector<int> getAvailableMoves() const;
+
+    /**
+     * @brief Writes all the available moves into a move list.
+     *
+     * On boards larger than `FULL_WIDTH_CELLS`, only the empty cells within `CANDIDATE_DISTANCE`
+     * of a marker are listed, or the central cell on an empty board.
+     * @param moves The list to fill with the indices of empty cells.
+     */
+    void generateMoves(MoveList &moves) const;
+
+    /**
+     * @brief Checks if at least one cell is empty.
+     * @return true if a move can be made, false otherwise.
+     */
+    [[nodiscard]] bool hasMoves() const;
 
    /**
    * @brief Makes a move at the specified position.
    * @param cellIndex The index of the cell where the move will be made.
    */
-    void makeMove(int cellIndex) override;
+    void makeMove(int cellIndex);
 
     /**
     * @brief Undoes the move at the specified position.
     * @param cellIndex The index of the cell to be cleared.
     */
-    void undoMove(int cellIndex) override;
+    void undoMove(int cellIndex);
 
     /**
     * @brief Evaluates the current board state to calculate a score.
-    * @return A score representing the evaluation of the board:
-    *         10 for an AI win, -10 for a player win, 0 for a draw or ongoing game.
+    * @return WIN_SCORE if the AI wins, -WIN_SCORE if the player wins, 0 for a draw,
+    *         otherwise a heuristic score of the lines still open to one player only.
     */
-    [[nodiscard]] int evaluate() const override;
+    [[nodiscard]] int evaluate() const;
 
     /**
     * @brief Determines the winner of the game.
     * @return 1 if the player wins, -1 if the AI wins, 0 if there is no winner.
     */
-    [[nodiscard]] int getWinner() const override;
+    [[nodiscard]] int getWinner() const;
+
+    /**
+    * @brief Gets the Zobrist hash of the current board.
+    * @return A 64-bit hash of the board and of the player to move.
+    */
+    [[nodiscard]] uint64_t getHash() const;
+
+    /**
+    * @brief Gets the hash shared by the board and its images by the symmetries of the board.
+    * @return The smallest of the hashes of the images of the board.
+    */
+    [[nodiscard]] uint64_t getCanonicalHash() const;
+
+    /**
+    * @brief Maps a cell to the same cell on the canonical image of the board.
+    * @param move The index of the cell.
+    * @return The image of the cell by the symmetry giving the canonical image.
+    */
+    [[nodiscard]] int toCanonicalMove(int move) const;
+
+    /**
+    * @brief Maps a cell of the canonical image of the board back to the board.
+    * @param move The index of a cell of the canonical image.
+    * @return The cell whose image by the symmetry giving the canonical image it is.
+    */
+    [[nodiscard]] int fromCanonicalMove(int move) const;
+
+    /**
+    * @brief Encodes the board as a line of text.
+    * @return The rows separated by `/`, then the player to move and the alignment.
+    */
+    [[nodiscard]] std::string toString() const;
+
+    /**
+    * @brief Decodes a board encoded by toString().
+    * @param text The encoding: the rows from top to bottom separated by `/`, each cell being `X`,
+    *             `O` or `.`, then the player to move, `X` or `O`, then the number of aligned markers
+    *             winning the game. For instance `X.O/.X./... O 3`.
+    * @return The board, or nothing if the text is not a valid board.
+    */
+    [[nodiscard]] static std::optional<TicTacToe> fromString(const std::string &text);
 
     /**
     * @brief Validates the player's input to ensure it is a valid move.
     * @param input The input position provided by the player.
     * @return true if the input is valid, false otherwise.
     */
-    [[nodiscard]] bool checkInput(int input) const override;
+    [[nodiscard]] bool checkInput(int input) const;
 
     /**
-    * @brief Asks the player for their input.
+    * @brief Asks the player for their input: a cell number on the classic board, a row and a column otherwise.
     * @return The index of the cell chosen by the player.
     */
-    [[nodiscard]] int askInput() const override;
+    [[nodiscard]] int askInput() const;
 };
 
-
+static_assert(std::is_trivially_copyable_v<TicTacToe>, "The searches copy the boards instead of undoing moves.");
+static_assert(sizeof(TicTacToe) <= 2048, "A copy moves the line counters of the largest board, keep it within 2 KiB.");
 
 #endif //TICTACTOE_H
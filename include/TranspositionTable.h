@@ -0,0 +1,119 @@
+/**
+ * @file TranspositionTable.h
+ * @brief Declaration of the transposition table used by the search.
+ */
+
+#ifndef TRANSPOSITIONTABLE_H
+#define TRANSPOSITIONTABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+constexpr std::size_t DEFAULT_TT_SIZE_MB = 16; ///< Default size of the transposition table, in MiB.
+
+/**
+ * @enum Bound
+ * @brief Describes how a stored score relates to the real score of the position.
+ */
+enum class Bound : uint8_t {
+    None,  ///< The entry is empty.
+    Exact, ///< The stored score is the real score.
+    Lower, ///< The real score is at least the stored score.
+    Upper  ///< The real score is at most the stored score.
+};
+
+/**
+ * @struct TTEntry
+ * @brief A search result stored in the transposition table.
+ */
+struct TTEntry {
+    static constexpr int MAX_DEPTH = INT16_MAX; ///< Deeper searches are stored with this depth.
+
+    uint64_t key = 0;          ///< Full hash of the position, used to detect index collisions.
+    int16_t score = 0;         ///< The score found by the search.
+    int16_t move = -1;         ///< The best move found, or -1 if unknown.
+    int16_t depth = 0;         ///< The remaining depth the position was searched to.
+    Bound bound = Bound::None; ///< How the score relates to the real score.
+};
+
+/**
+ * @struct TTSlot
+ * @brief The storage of one entry, readable and writable by several threads without locking.
+ *
+ * The fields of the entry are packed into one 64-bit word and the key is stored XORed with that
+ * word. A slot torn by two concurrent writes no longer satisfies `check ^ data == key`, so a
+ * probe rejects it instead of returning a mix of two results.
+ */
+struct TTSlot {
+    std::atomic<uint64_t> check{0}; ///< The key of the entry XORed with its data.
+    std::atomic<uint64_t> data{0};  ///< The packed score, move, depth and bound.
+};
+
+/**
+ * @struct TTBucket
+ * @brief A group of entries sharing one cache line.
+ *
+ * A probe reads a single cache line and chooses among the entries of the bucket.
+ */
+struct alignas(64) TTBucket {
+    static constexpr int SIZE = 4; ///< The number of entries per bucket.
+    TTSlot slots[SIZE];            ///< The entries of the bucket.
+};
+
+static_assert(sizeof(TTBucket) == 64, "A bucket must fill exactly one cache line.");
+
+/**
+ * @class TranspositionTable
+ * @brief Fixed-size hash table caching search results by position hash.
+ *
+ * The table holds a power-of-two number of cache-line-aligned buckets. When a bucket is full,
+ * the entry searched to the smallest depth is replaced.
+ *
+ * Probes and stores are lock-free and may run concurrently from any number of threads, which lets
+ * parallel searches share one table. Resizing and clearing must not run concurrently with a search.
+ */
+class TranspositionTable {
+private:
+    std::unique_ptr<TTBucket[]> buckets; ///< The storage of the table.
+    uint64_t indexMask = 0; ///< Mask applied to a hash to get its bucket index.
+
+public:
+    /**
+     * @brief Constructs a transposition table.
+     * @param sizeMb The size of the table, in MiB. It is rounded down to a power of two buckets.
+     */
+    explicit TranspositionTable(std::size_t sizeMb = DEFAULT_TT_SIZE_MB);
+
+    /**
+     * @brief Changes the size of the table. All stored entries are lost.
+     * @param sizeMb The new size of the table, in MiB.
+     */
+    void resize(std::size_t sizeMb);
+
+    /**
+     * @brief Removes all stored entries.
+     */
+    void clear();
+
+    /**
+     * @brief Looks up a position.
+     * @param key The hash of the position.
+     * @param entry Receives the entry of the position when it is stored.
+     * @return true if the position is stored, false otherwise.
+     */
+    [[nodiscard]] bool probe(uint64_t key, TTEntry &entry) const;
+
+    /**
+     * @brief Stores a search result.
+     * @param key The hash of the position.
+     * @param depth The remaining depth the position was searched to.
+     * @param bound How the score relates to the real score.
+     * @param score The score found by the search.
+     * @param move The best move found, or -1 if unknown.
+     */
+    void store(uint64_t key, int depth, Bound bound, int score, int move);
+};
+
+#endif //TRANSPOSITIONTABLE_H
@@ -0,0 +1,55 @@
+/**
+ * @file Zobrist.h
+ * @brief Helpers to generate the random keys used for Zobrist hashing.
+ *
+ * A position hash is the XOR of one key per occupied cell (or per state component) and of
+ * `SIDE_KEY` when the AI is to move. Adding or removing a piece is then a single XOR, which lets
+ * the games maintain their hash incrementally in `makeMove`/`undoMove`.
+ */
+
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace Zobrist
+{
+    /**
+     * @brief Derives a well-mixed 64-bit key from an index (SplitMix64 finalizer).
+     *
+     * The keys are computed at compile time, so they are identical across runs and builds,
+     * which keeps hashes stored on disk valid.
+     * @param index The index of the key.
+     * @return The key associated with the index.
+     */
+    constexpr uint64_t key(uint64_t index)
+    {
+        index += 0x9E3779B97F4A7C15ULL;
+        index = (index ^ (index >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        index = (index ^ (index >> 27)) * 0x94D049BB133111EBULL;
+        return index ^ (index >> 31);
+    }
+
+    /**
+     * @brief Generates a table of consecutive keys.
+     * @tparam N The number of keys in the table.
+     * @param seed The index of the first key. Each table should use a distinct range of indices.
+     * @return The table of keys.
+     */
+    template <std::size_t N>
+    constexpr std::array<uint64_t, N> makeKeys(const uint64_t seed)
+    {
+        std::array<uint64_t, N> keys{};
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            keys[i] = key(seed + i);
+        }
+        return keys;
+    }
+
+    constexpr uint64_t SIDE_KEY = key(0); ///< Toggled in the hash whenever the player to move changes.
+}
+
+#endif //ZOBRIST_H
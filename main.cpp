@@ -3,90 +3,223 @@
  * @brief A program to play various games (Tic-Tac-Toe, Connect 4, Sticks game) with AI using the MinMax algorithm.
  */
 
+#include <chrono>
+#include <fstream>
 #include <iostream>
-#include <vector>
-#include <limits>
-#include <memory>
+#include <optional>
 #include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
 
+#include "AlphaBeta.h"
+#include "AsyncSearch.h"
+#include "BatchAnalysis.h"
+#include "Mcts.h"
 #include "Game.h"
+#include "GameAdapter.h"
+#ifndef _WIN32
+#include "GameServer.h"
+#endif
 #include "Connect4.h"
+#include "OpeningBook.h"
+#include "PerfectPlay.h"
+#include "SearchTraits.h"
+#include "SelfPlay.h"
 #include "SticksGame.h"
+#include "SticksSolver.h"
 #include "TicTacToe.h"
 
 using namespace std;
 
 /**
- * @brief MinMax algorithm to calculate the optimal score for the current game state.
- *
- * @param game Reference to the current game object.
- * @param depth The current depth of the recursive search.
- * @param isMaximizing Boolean flag to indicate whether the current player is maximizing or minimizing the score.
- * @return int The best score for the current player.
+ * @struct Options
+ * @brief The settings of the program, read from the command line.
  */
-int minMax(Game &game, const int depth, const bool isMaximizing)
-{
-    int maxDepth = 999999;
-    if (dynamic_cast<Connect4*>(&game))
-    {
-        // Limit the recursion depth to avoid excessive computation.
-        // A depth of 6 is chosen as a balance between performance and decision quality.
-        maxDepth = 6;
-    }
-    if (depth >= maxDepth || game.isTerminal())
-    {
-        return game.evaluate(); // Return the evaluation of the current state.
-    }
-
-    // Initialize the best score based on whether we are maximizing or minimizing.
-    int bestScore = isMaximizing ? std::numeric_limits<int>::min() : std::numeric_limits<int>::max();
+struct Options {
+    size_t ttSizeMb = DEFAULT_TT_SIZE_MB; ///< The size of the AI's transposition table, in MiB.
+    chrono::milliseconds timeBudget{0}; ///< The time the AI may think per move, or 0 to use the default of the game.
+    int threads = 1; ///< The number of threads the AI searches with.
+    SearchEngine ticTacToeEngine = SearchEngine::AlphaBeta; ///< The algorithm of the AI at Tic-Tac-Toe.
+    SearchEngine connect4Engine = SearchEngine::AlphaBeta; ///< The algorithm of the AI at Connect 4.
+    SearchEngine sticksEngine = SearchEngine::AlphaBeta; ///< The algorithm of the AI at the Sticks game.
+    bool ponder = false; ///< Whether the AI searches while waiting for the user's move.
+    bool solved = false; ///< Whether the AI plays the small games from a perfect-play solver.
+    int rows = BOARD_SIZE; ///< The number of rows of the Tic-Tac-Toe board.
+    int columns = BOARD_SIZE; ///< The number of columns of the Tic-Tac-Toe board.
+    int alignment = BOARD_SIZE; ///< The number of aligned markers winning Tic-Tac-Toe.
+    int sticks = STICKS_NUMBER; ///< The initial number of sticks of the Sticks game.
+    int maxTake = MAX_TAKE; ///< The maximum number of sticks taken per move in the Sticks game.
+    string connect4Size = "7x6"; ///< The columns and rows of the Connect 4 board: 7x6, 8x7 or 9x7.
+    string bookPath; ///< The opening book of the classic Connect 4 board, or empty for none.
+    int selfPlayGames = 0; ///< The number of headless games to play per game type, or 0 to play interactively.
+    Opponent opponent = Opponent::Engine; ///< Who plays against the AI in headless games.
+    int serverPort = 0; ///< The TCP port to serve games on, or 0 to play on the console.
+    int workers = static_cast<int>(max(1u, thread::hardware_concurrency())); ///< The number of searches the server runs at once.
+    string analyzePath; ///< The file of positions to analyze, `-` for the standard input, or empty to play.
+    int maxDepth = 0; ///< The depth of each analysis, or 0 to use the default of the game.
+};
 
-    // Loop through all available moves.
-    for (const auto move : game.getAvailableMoves())
-    {
-        game.makeMove(move); // Apply the move.
+/**
+ * @brief Sets the algorithm of the AI from a command-line value.
+ * @param options The settings to update.
+ * @param value `alphabeta` or `mcts`, for every game, or prefixed by `tictactoe:`, `connect4:`
+ *              or `sticks:` for one game.
+ * @return false if the value is not recognized, true otherwise.
+ */
+bool setEngine(Options &options, const string &value)
+{
+    const size_t separator = value.find(':');
+    const string game = separator == string::npos ? "" : value.substr(0, separator);
+    const string name = separator == string::npos ? value : value.substr(separator + 1);
 
-        // Recursively call MinMax for the next depth and toggle the maximizing flag.
-        int score = minMax(game, depth + 1, !isMaximizing);
+    SearchEngine engine;
+    if (name == "alphabeta") engine = SearchEngine::AlphaBeta;
+    else if (name == "mcts") engine = SearchEngine::Mcts;
+    else return false;
 
-        // Undo the move to restore the game state.
-        game.undoMove(move);
+    if (game.empty() || game == "tictactoe") options.ticTacToeEngine = engine;
+    if (game.empty() || game == "connect4") options.connect4Engine = engine;
+    if (game.empty() || game == "sticks") options.sticksEngine = engine;
+    return game.empty() || game == "tictactoe" || game == "connect4" || game == "sticks";
+}
 
-        // Update the best score based on whether we are maximizing or minimizing.
-        bestScore = isMaximizing ? std::max(bestScore, score) : std::min(bestScore, score);
-    }
+/**
+ * @brief Gets the algorithm of the AI at a game.
+ * @tparam TGame The concrete game type.
+ * @param options The settings of the program.
+ * @return The engine chosen for the game.
+ */
+template <typename TGame>
+SearchEngine engineOf(const Options &options)
+{
+    if constexpr (is_same_v<TGame, TicTacToe>) return options.ticTacToeEngine;
+    else if constexpr (is_same_v<TGame, SticksGame>) return options.sticksEngine;
+    else return options.connect4Engine;
+}
 
-    return bestScore;
+/**
+ * @brief Calls a function with the type of the Connect 4 variant of a board size.
+ *
+ * The board size of Connect 4 is a template parameter, so only the variants compiled here can be played.
+ * @tparam TFunction A callable taking a `type_identity` of the variant.
+ * @param size The columns and rows of the board: 7x6, 8x7 or 9x7.
+ * @param function The function to call.
+ * @return false if no variant has this size, true otherwise.
+ */
+template <typename TFunction>
+bool withConnect4(const string &size, TFunction function)
+{
+    if (size == "7x6") function(type_identity<Connect4>());
+    else if (size == "8x7") function(type_identity<Connect4Large>());
+    else if (size == "9x7") function(type_identity<Connect4Wide>());
+    else return false;
+    return true;
 }
 
 /**
- * @brief Determines the best move for the AI using the MinMax algorithm.
+ * @brief Plays one game between the user and the AI.
+ *
+ * The players alternate turns until the game reaches a terminal state, then the result is displayed.
+ * When pondering, the AI searches the user's replies while waiting for them, without time limit.
+ * The search fills the transposition table, so the AI's next search finds most of its tree there.
+ * The Monte Carlo engine, when chosen for the game, neither ponders nor uses the book.
+ * The console plays through the `Game` interface, the searches on the adapted game state.
  *
- * @param game Reference to the current game object.
- * @return int The index of the best move for the AI.
+ * @tparam TGame The concrete game type, for which the AI's search is specialized.
+ * @tparam TSolver The solver type, providing `getBestMove(const TGame&)`.
+ * @param start The game to play, in its initial state.
+ * @param options The settings of the AI's search.
+ * @param solved The perfect-play solver of the game, replacing the search, or nullptr to search.
+ * @param book The opening book checked before searching, or nullptr.
  */
-int getBestMove(Game &game)
+template <typename TGame, typename TSolver = PerfectPlay<TGame>>
+void play(const TGame &start, const Options &options, const TSolver* solved = nullptr, const OpeningBook* book = nullptr)
 {
-    int bestScore = std::numeric_limits<int>::min();
-    int bestMove = -1;
+    GameAdapter<TGame> adapter(start);
+    Game &game = adapter;
+    TGame &state = adapter.get();
+
+    AlphaBeta<TGame> engine(options.ttSizeMb);
+    engine.setOpeningBook(book);
+    std::optional<Mcts<TGame>> mcts;
+    if (engineOf<TGame>(options) == SearchEngine::Mcts) mcts.emplace();
+    SearchLimits limits = SearchLimits::defaults<TGame>();
+    if (options.timeBudget.count() > 0) limits.timeBudget = options.timeBudget;
+    limits.threads = options.threads;
 
-    for (const auto move : game.getAvailableMoves())
+    cout << "Welcome to the game!\n";
+
+    while (!game.isTerminal())
     {
-        game.makeMove(move); // Apply the move.
+        game.display();
+
+        // Player's turn
+        if(game.getCurrentPlayer() == game.PLAYER)
+        {
+            std::optional<AsyncSearch<TGame>> ponder;
+            if (options.ponder && !solved && !mcts)
+            {
+                SearchLimits ponderLimits = limits;
+                ponderLimits.timeBudget = chrono::milliseconds(0);
+                ponder.emplace(engine, state, ponderLimits);
+            }
 
-        // Evaluate the move using the MinMax algorithm, starting at depth 0.
-        const int score = minMax(game, 0, false);
-        game.undoMove(move); // Undo the move to restore the game state.
+            int input;
+            do
+            {
+                input = game.askInput();
+            }
+            while (!game.checkInput(input));
+            ponder.reset(); // Stops the search before the engine is used again.
 
-        // If the score for this move is better than the current best score, update bestScore and bestMove.
-        if (score > bestScore)
+            game.makeMove(input);
+            if (game.isTerminal()) break;
+        }
+        // AI's turn
+        else
         {
-            bestScore = score;
-            bestMove = move;
+            const int bestMove = solved ? solved->getBestMove(state)
+                                 : mcts ? mcts->getBestMove(state, limits)
+                                 : engine.getBestMove(state, limits);
+            game.makeMove(bestMove);
         }
     }
 
-    return bestMove;
+    game.display();
+    const int winner = game.getWinner();
+    if (winner == game.PLAYER) cout << "You win!\n\n";
+    else if (winner == game.AI) cout << "AI wins!\n\n";
+    else cout << "It's a draw!\n\n";
+}
+
+/**
+ * @brief Plays a batch of headless games and prints their results.
+ * @tparam TGame The concrete game type.
+ * @tparam TFactory A callable taking `bool userIsStarting` and returning a new game.
+ * @param name The name of the game.
+ * @param makeGame Creates the game in its initial state.
+ * @param options The settings of the batch and of the AI's search.
+ */
+template <typename TGame, typename TFactory>
+void selfPlay(const char* name, TFactory makeGame, const Options &options)
+{
+    SelfPlayOptions selfPlayOptions;
+    selfPlayOptions.games = options.selfPlayGames;
+    selfPlayOptions.threads = options.threads;
+    selfPlayOptions.opponent = options.opponent;
+    selfPlayOptions.ttSizeMb = options.ttSizeMb;
+    selfPlayOptions.engine = engineOf<TGame>(options);
+
+    SearchLimits limits = SearchLimits::defaults<TGame>();
+    if (options.timeBudget.count() > 0) limits.timeBudget = options.timeBudget;
+
+    const SelfPlayReport report = runSelfPlay<TGame>(makeGame, selfPlayOptions, limits);
+    cout << name << ": " << report.games << " games, AI wins " << 100.0 * report.aiWins / report.games
+         << "%, opponent wins " << 100.0 * report.opponentWins / report.games
+         << "%, draws " << 100.0 * report.draws / report.games << "%, "
+         << report.moves << " moves in " << report.seconds << " s (" << report.movesPerSecond() << " moves/s)\n";
 }
 
 /**
@@ -95,11 +228,158 @@ int getBestMove(Game &game)
  * The user is prompted to choose a game, and the program alternates turns between the player and the AI
  * until the game reaches a terminal state. The final result is displayed to the user.
  *
+ * The size of the AI's transposition table can be set with `--hash <MiB>`, the time it may think
+ * per move with `--time <ms>`, and the number of search threads with `--threads <count>`.
+ * `--engine mcts` makes the AI choose its moves with a Monte Carlo tree search instead of the
+ * alpha-beta search, and `--engine <game>:<alphabeta|mcts>` chooses the algorithm of one game only,
+ * the games being `tictactoe`, `connect4` and `sticks`. The option may be repeated.
+ * With `--ponder`, the AI keeps searching while the user thinks about their move.
+ * With `--solved`, the AI plays Tic-Tac-Toe and the Sticks game from a perfect-play table
+ * generated when the game starts, instead of searching every move.
+ * Tic-Tac-Toe is played on `--rows <count>` by `--columns <count>` cells, won by aligning
+ * `--align <count>` markers, e.g. `--rows 15 --columns 15 --align 5` for Gomoku. Only boards of
+ * at most 9 cells are solved.
+ * The Sticks game starts with `--sticks <count>` sticks, of which at most `--take <count>` are
+ * removed per move. Large variants should be played with `--solved`.
+ * Connect 4 is played on the classic 7x6 board, or with `--connect4 <8x7|9x7>` on a larger one.
+ * `--book <path>` opens an opening book for the classic board.
+ *
+ * `--selfplay <games>` plays that many headless games of every game type instead, with
+ * `--threads` games in parallel, against the engine itself or against random moves with
+ * `--opponent random`, and prints the win and draw rates and the number of moves per second.
+ *
+ * `--server <port>` serves games to TCP clients instead (see `GameServer` for the protocol), with
+ * `--workers <count>` searches running at once.
+ *
+ * `--analyze <path>` prints the best move and score of every position of a file, `-` reading
+ * the standard input (see `analyzePositions()` for the format), with `--threads` positions
+ * analyzed in parallel and searches limited by `--time` and `--depth <plies>`.
+ *
+ * @param argc The number of command-line arguments.
+ * @param argv The command-line arguments.
  * @return int Exit status of the program.
  */
-int main()
+int main(const int argc, char* argv[])
 {
-    unique_ptr<Game> game;
+    Options options;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (string(argv[i]) == "--solved") options.solved = true;
+        else if (string(argv[i]) == "--ponder") options.ponder = true;
+        else if (i + 1 == argc) break;
+        else if (string(argv[i]) == "--hash") options.ttSizeMb = stoul(argv[++i]);
+        else if (string(argv[i]) == "--time") options.timeBudget = chrono::milliseconds(stol(argv[++i]));
+        else if (string(argv[i]) == "--threads") options.threads = stoi(argv[++i]);
+        else if (string(argv[i]) == "--engine")
+        {
+            if (!setEngine(options, argv[++i]))
+            {
+                cout << "Unknown engine " << argv[i] << ": expected [tictactoe:|connect4:|sticks:]<alphabeta|mcts>.\n";
+                return 1;
+            }
+        }
+        else if (string(argv[i]) == "--rows") options.rows = stoi(argv[++i]);
+        else if (string(argv[i]) == "--columns") options.columns = stoi(argv[++i]);
+        else if (string(argv[i]) == "--align") options.alignment = stoi(argv[++i]);
+        else if (string(argv[i]) == "--sticks") options.sticks = stoi(argv[++i]);
+        else if (string(argv[i]) == "--take") options.maxTake = stoi(argv[++i]);
+        else if (string(argv[i]) == "--connect4") options.connect4Size = argv[++i];
+        else if (string(argv[i]) == "--book") options.bookPath = argv[++i];
+        else if (string(argv[i]) == "--selfplay") options.selfPlayGames = stoi(argv[++i]);
+        else if (string(argv[i]) == "--server") options.serverPort = stoi(argv[++i]);
+        else if (string(argv[i]) == "--workers") options.workers = stoi(argv[++i]);
+        else if (string(argv[i]) == "--analyze") options.analyzePath = argv[++i];
+        else if (string(argv[i]) == "--depth") options.maxDepth = stoi(argv[++i]);
+        else if (string(argv[i]) == "--opponent") options.opponent = string(argv[++i]) == "random" ? Opponent::Random : Opponent::Engine;
+    }
+    if (options.sticks < 1 || options.maxTake < 1 || options.maxTake > MAX_TAKE_LIMIT)
+    {
+        cout << "The Sticks game needs at least 1 stick and a take between 1 and " << MAX_TAKE_LIMIT << ".\n";
+        return 1;
+    }
+    try
+    {
+        (void) TicTacToe(true, options.rows, options.columns, options.alignment);
+    }
+    catch (const invalid_argument &error)
+    {
+        cout << "Invalid Tic-Tac-Toe board: " << error.what() << ".\n";
+        return 1;
+    }
+
+    if (!withConnect4(options.connect4Size, [](auto) {}))
+    {
+        cout << "The Connect 4 board must be 7x6, 8x7 or 9x7.\n";
+        return 1;
+    }
+
+    OpeningBook book;
+    if (!options.bookPath.empty() && !book.open(options.bookPath))
+    {
+        cout << "Could not open the opening book " << options.bookPath << ".\n";
+        return 1;
+    }
+
+    if (!options.analyzePath.empty())
+    {
+        AnalysisOptions analysisOptions;
+        analysisOptions.threads = options.threads;
+        analysisOptions.ttSizeMb = options.ttSizeMb;
+        analysisOptions.timeBudget = options.timeBudget;
+        analysisOptions.maxDepth = options.maxDepth;
+
+        ifstream file;
+        if (options.analyzePath != "-")
+        {
+            file.open(options.analyzePath);
+            if (!file)
+            {
+                cout << "Could not open the positions " << options.analyzePath << ".\n";
+                return 1;
+            }
+        }
+        const AnalysisReport report = analyzePositions(file.is_open() ? file : cin, cout, analysisOptions);
+        cerr << report.positions << " positions analyzed, " << report.errors << " invalid, in " << report.seconds << " s\n";
+        return 0;
+    }
+
+#ifndef _WIN32
+    if (options.serverPort > 0)
+    {
+        ServerOptions serverOptions;
+        serverOptions.port = static_cast<uint16_t>(options.serverPort);
+        serverOptions.workers = options.workers;
+        serverOptions.ttSizeMb = options.ttSizeMb;
+        serverOptions.timeBudget = options.timeBudget;
+
+        GameServer server(serverOptions);
+        cout << "Serving games on port " << options.serverPort << "." << endl;
+        if (!server.run())
+        {
+            cout << "Could not listen on port " << options.serverPort << ".\n";
+            return 1;
+        }
+        return 0;
+    }
+#endif
+
+    if (options.selfPlayGames > 0)
+    {
+        selfPlay<TicTacToe>("Tic-Tac-Toe", [&](const bool userIsStarting)
+        {
+            return TicTacToe(userIsStarting, options.rows, options.columns, options.alignment);
+        }, options);
+        withConnect4(options.connect4Size, [&](auto variant)
+        {
+            using TGame = typename decltype(variant)::type;
+            selfPlay<TGame>("Connect 4", [](const bool userIsStarting) { return TGame(userIsStarting); }, options);
+        });
+        selfPlay<SticksGame>("Sticks game", [&](const bool userIsStarting)
+        {
+            return SticksGame(userIsStarting, options.sticks, options.maxTake);
+        }, options);
+        return 0;
+    }
 
     // Initialize the random number generator
     std::random_device rd;
@@ -123,14 +403,38 @@ int main()
         switch (choice)
         {
             case 1:
-                game = make_unique<TicTacToe>(isUserStarting);
+            {
+                TicTacToe game(isUserStarting, options.rows, options.columns, options.alignment);
+                if (options.solved && game.getRows() * game.getColumns() <= BOARD_SIZE * BOARD_SIZE)
+                {
+                    const PerfectPlay table(game);
+                    play(game, options, &table);
+                }
+                else play(game, options);
                 break;
+            }
             case 2:
-                game = make_unique<Connect4>(isUserStarting);
+            {
+                withConnect4(options.connect4Size, [&](auto variant)
+                {
+                    using TGame = typename decltype(variant)::type;
+                    TGame game(isUserStarting);
+                    const bool classic = is_same_v<TGame, Connect4>;
+                    play<TGame, PerfectPlay<TGame>>(game, options, nullptr, classic && book.isOpen() ? &book : nullptr);
+                });
                 break;
+            }
             case 3:
-                game = make_unique<SticksGame>(isUserStarting);
+            {
+                SticksGame game(isUserStarting, options.sticks, options.maxTake);
+                if (options.solved)
+                {
+                    const SticksSolver solver(options.sticks, options.maxTake);
+                    play(game, options, &solver);
+                }
+                else play(game, options);
                 break;
+            }
             case 4:
                 cout << "Quiting game.\n";
                 return 0;
@@ -139,38 +443,5 @@ int main()
                 cout << "Invalid choice.\n";
                 return 0;
         }
-
-        cout << "Welcome to the game!\n";
-
-        while (!game->isTerminal())
-        {
-            game->display();
-
-            // Player's turn
-            if(game->getCurrentPlayer() == game->PLAYER)
-            {
-                int input;
-                do
-                {
-                    input = game->askInput();
-                }
-                while (!game->checkInput(input));
-
-                game->makeMove(input);
-                if (game->isTerminal()) break;
-            }
-            // AI's turn
-            else
-            {
-                const int bestMove = getBestMove(*game);
-                game->makeMove(bestMove);
-            }
-        }
-
-        game->display();
-        const int winner = game->getWinner();
-        if (winner == game->PLAYER) cout << "You win!\n\n";
-        else if (winner == game->AI) cout << "AI wins!\n\n";
-        else cout << "It's a draw!\n\n";
     }
 }
@@ -0,0 +1,111 @@
+/**
+ * @file Arena.cpp
+ * @brief Implementation of a bump allocator releasing all its objects at once.
+ */
+
+#include "Arena.h"
+#include <algorithm>
+#include <cstdint>
+
+/**
+ * @brief Constructs an empty arena. No memory is taken until the first allocation.
+ * @param blockSize The size of the blocks, in bytes.
+ */
+Arena::Arena(const std::size_t blockSize) : blockSize(std::max<std::size_t>(blockSize, 64))
+{
+}
+
+/**
+ * @brief Destroys the objects and releases the blocks.
+ */
+Arena::~Arena()
+{
+    reset();
+}
+
+/**
+ * @brief Moves to the next block large enough for an allocation, creating it if needed.
+ *
+ * The blocks kept from before the last reset are reused first. A block too small for the
+ * allocation is skipped; when none is left, a block large enough is added.
+ * @param size The size of the allocation, in bytes, including the alignment padding.
+ */
+void Arena::nextBlock(const std::size_t size)
+{
+    if (!blocks.empty())
+    {
+        used += offset;
+        ++current;
+    }
+    while (current < blocks.size() && blocks[current].size < size)
+    {
+        ++current;
+    }
+    if (current == blocks.size())
+    {
+        const std::size_t newSize = std::max(size, blockSize);
+        blocks.push_back(Block{std::make_unique<std::byte[]>(newSize), newSize});
+    }
+    offset = 0;
+}
+
+/**
+ * @brief Allocates uninitialized memory.
+ * @param size The number of bytes.
+ * @param alignment The alignment of the memory, a power of two.
+ * @return The memory, valid until the next reset.
+ */
+void* Arena::allocate(const std::size_t size, const std::size_t alignment)
+{
+    const auto padding = [&]
+    {
+        const auto address = reinterpret_cast<std::uintptr_t>(blocks[current].memory.get()) + offset;
+        return (alignment - address % alignment) % alignment;
+    };
+
+    if (blocks.empty() || offset + padding() + size > blocks[current].size)
+    {
+        nextBlock(size + alignment);
+    }
+    offset += padding();
+    void* memory = blocks[current].memory.get() + offset;
+    offset += size;
+    return memory;
+}
+
+/**
+ * @brief Destroys every object and makes all the memory available again, without releasing it.
+ */
+void Arena::reset()
+{
+    for (; cleanups; cleanups = cleanups->next)
+    {
+        cleanups->destroy(cleanups->object);
+    }
+    current = 0;
+    offset = 0;
+    used = 0;
+}
+
+/**
+ * @brief Gets the memory handed out since the last reset.
+ * @return The number of bytes allocated, including the alignment padding.
+ */
+std::size_t Arena::bytesUsed() const
+{
+    return used + offset;
+}
+
+/**
+ * @brief Gets the memory held by the arena.
+ * @return The total size of the blocks, in bytes.
+ */
+std::size_t Arena::bytesReserved() const
+{
+    std::size_t total = 0;
+    for (const Block &block : blocks)
+    {
+        total += block.size;
+    }
+    return total;
+}
@@ -0,0 +1,156 @@
+/**
+ * @file BatchAnalysis.cpp
+ * @brief Implementation of the offline analysis of a stream of positions.
+ */
+
+#include "BatchAnalysis.h"
+#include "AlphaBeta.h"
+#include "Connect4.h"
+#include "SearchTraits.h"
+#include "SticksGame.h"
+#include "ThreadPool.h"
+#include "TicTacToe.h"
+
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace
+{
+    /**
+     * @struct Engine
+     * @brief The engine of one thread for a game, and the parameters of the positions it searched.
+     * @tparam TGame The concrete game type.
+     */
+    template <typename TGame>
+    struct Engine {
+        std::unique_ptr<AlphaBeta<TGame>> search; ///< The engine, created on the first position of the game.
+        std::string variant; ///< The parameters of the game not given by its type, see getVariant().
+    };
+
+    /**
+     * @struct Engines
+     * @brief The engines of one thread, created on the first position of their game.
+     */
+    struct Engines {
+        Engine<TicTacToe> ticTacToe; ///< The Tic-Tac-Toe engine.
+        Engine<Connect4> connect4; ///< The Connect 4 engine.
+        Engine<SticksGame> sticks; ///< The Sticks game engine.
+    };
+
+    /**
+     * @brief Analyzes one position of a game.
+     *
+     * The transposition table is cleared when the parameters of the game differ from those of the
+     * previous position, so that no entry of another variant is reused.
+     * @tparam TGame The concrete game type.
+     * @param engine The engine of the game, created if needed.
+     * @param encoding The position, as given by `toString()`.
+     * @param options The settings of the analysis.
+     * @return The result line, without a newline.
+     */
+    template <typename TGame>
+    std::string analyze(Engine<TGame> &engine, const std::string &encoding, const AnalysisOptions &options)
+    {
+        std::optional<TGame> game = TGame::fromString(encoding);
+        if (!game) return "ERR Invalid position";
+        if (game->isTerminal()) return "-1 " + std::to_string(game->evaluate());
+
+        SearchLimits limits = SearchLimits::defaults<TGame>();
+        if (options.timeBudget.count() > 0) limits.timeBudget = options.timeBudget;
+        if (options.maxDepth > 0) limits.maxDepth = options.maxDepth;
+
+        std::string variant = game->getVariant();
+        if (!engine.search) engine.search = std::make_unique<AlphaBeta<TGame>>(options.ttSizeMb);
+        else if (variant != engine.variant) engine.search->clear();
+        engine.variant = std::move(variant);
+
+        const SearchResult result = engine.search->findBestMove(*game, limits);
+        return std::to_string(result.move) + " " + std::to_string(result.score);
+    }
+
+    /**
+     * @brief Analyzes one input line.
+     * @param engines The engines of the calling thread.
+     * @param line The game name and the encoding of the position.
+     * @param options The settings of the analysis.
+     * @return The result line, without a newline.
+     */
+    std::string analyzeLine(Engines &engines, const std::string &line, const AnalysisOptions &options)
+    {
+        const std::size_t separator = line.find(' ');
+        const std::string name = line.substr(0, separator);
+        const std::string encoding = separator == std::string::npos ? "" : line.substr(separator + 1);
+
+        if (name == "tictactoe") return analyze(engines.ticTacToe, encoding, options);
+        if (name == "connect4") return analyze(engines.connect4, encoding, options);
+        if (name == "sticks") return analyze(engines.sticks, encoding, options);
+        return "ERR Unknown game";
+    }
+}
+
+/**
+ * @brief Finds the best move of every position of a stream.
+ *
+ * A chunk is written once all its positions are analyzed, so the output keeps the input order
+ * whatever the threads finish first.
+ * @param input The positions, one per line.
+ * @param output Receives one result per line.
+ * @param options The settings of the analysis.
+ * @return The totals of the analysis.
+ */
+AnalysisReport analyzePositions(std::istream &input, std::ostream &output, const AnalysisOptions &options)
+{
+    const auto start = std::chrono::steady_clock::now();
+    const int threads = std::max(1, options.threads);
+    const std::size_t chunkSize = std::max<std::size_t>(1, options.chunkSize);
+
+    AnalysisReport report;
+    ThreadPool pool(threads);
+    std::vector<Engines> engines(threads);
+    std::vector<std::string> lines;
+    std::vector<std::string> results;
+
+    bool more = true;
+    while (more)
+    {
+        lines.clear();
+        std::string line;
+        while (lines.size() < chunkSize && (more = static_cast<bool>(std::getline(input, line))))
+        {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            lines.push_back(line);
+        }
+        if (lines.empty()) break;
+
+        results.assign(lines.size(), std::string());
+        std::atomic<std::size_t> next{0};
+        std::vector<std::future<void>> workers;
+        for (int worker = 0; worker < threads; ++worker)
+        {
+            workers.push_back(pool.submit([&, worker]
+            {
+                for (std::size_t i = next++; i < lines.size(); i = next++)
+                {
+                    results[i] = analyzeLine(engines[worker], lines[i], options);
+                }
+            }));
+        }
+        for (auto &worker : workers) worker.get();
+
+        for (const std::string &result : results)
+        {
+            output << result << '\n';
+            if (result.rfind("ERR", 0) == 0) ++report.errors;
+        }
+        output.flush();
+        report.positions += static_cast<long long>(lines.size());
+    }
+
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return report;
+}
@@ -0,0 +1,64 @@
+/**
+ * @file Connect4Eval.cpp
+ * @brief Implementation of the detection of the instructions scoring Connect 4 boards.
+ */
+
+#include "Connect4Eval.h"
+
+/**
+ * @brief Checks if a kernel is compiled in and supported by the processor.
+ * @param kernel The kernel.
+ * @return true if `evaluateBoards()` runs the kernel, false if it would fall back to the scalar one.
+ */
+bool Connect4Eval::isSupported(const Kernel kernel)
+{
+    switch (kernel)
+    {
+        case Kernel::Scalar: return true;
+#if defined(MINMAX_CONNECT4_LANES2) && defined(__SSE2__)
+        case Kernel::Sse2: return true;
+#endif
+#if defined(MINMAX_CONNECT4_LANES2) && defined(__ARM_NEON)
+        case Kernel::Neon: return true;
+#endif
+#ifdef MINMAX_CONNECT4_AVX2
+        case Kernel::Avx2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2");
+#endif
+        default: return false;
+    }
+}
+
+/**
+ * @brief Gets the fastest kernel the processor supports, detected on the first call.
+ * @return The kernel `evaluateBoards()` uses by default.
+ */
+Connect4Eval::Kernel Connect4Eval::activeKernel()
+{
+    static const Kernel kernel = []
+    {
+        for (const Kernel candidate : {Kernel::Avx2, Kernel::Neon, Kernel::Sse2})
+        {
+            if (isSupported(candidate)) return candidate;
+        }
+        return Kernel::Scalar;
+    }();
+    return kernel;
+}
+
+/**
+ * @brief Gets the name of a kernel.
+ * @param kernel The kernel.
+ * @return The lowercase name of the kernel, e.g. "avx2".
+ */
+const char* Connect4Eval::kernelName(const Kernel kernel)
+{
+    switch (kernel)
+    {
+        case Kernel::Sse2: return "sse2";
+        case Kernel::Neon: return "neon";
+        case Kernel::Avx2: return "avx2";
+        default: return "scalar";
+    }
+}
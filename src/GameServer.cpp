@@ -0,0 +1,519 @@
+/**
+ * @file GameServer.cpp
+ * @brief Implementation of the TCP game server.
+ */
+
+#include "GameServer.h"
+#include "AlphaBeta.h"
+#include "AsyncSearch.h"
+#include "SearchTraits.h"
+#include <algorithm>
+#include <cerrno>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace
+{
+    constexpr std::size_t MAX_LINE_LENGTH = 4096; ///< Clients sending longer lines are disconnected.
+    constexpr std::chrono::milliseconds CANCEL_CHECK_INTERVAL{5}; ///< How often a worker checks whether to cancel its search.
+
+#ifdef MSG_NOSIGNAL
+    constexpr int SEND_FLAGS = MSG_NOSIGNAL; ///< A client closing its socket must not kill the server.
+#else
+    constexpr int SEND_FLAGS = 0;
+#endif
+
+    /**
+     * @brief Makes a file descriptor non-blocking.
+     * @param fd The file descriptor.
+     * @return true on success, false otherwise.
+     */
+    bool setNonBlocking(const int fd)
+    {
+        const int flags = fcntl(fd, F_GETFL, 0);
+        return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+    }
+
+    /**
+     * @brief Creates the state of a new game.
+     * @param name The name of the game: tictactoe, connect4 or sticks.
+     * @param userIsStarting Whether the client moves first.
+     * @param parameters The rows, columns and alignment of Tic-Tac-Toe, or the sticks and maximum take
+     *        of the Sticks game. Missing ones take their default value.
+     * @return The initial position, or nothing if the game is unknown.
+     * @throws std::invalid_argument If the parameters of the game are out of range.
+     */
+    std::optional<GameState> makeState(const std::string &name, const bool userIsStarting, const std::vector<int> &parameters)
+    {
+        const auto parameter = [&](const std::size_t index, const int fallback)
+        {
+            return index < parameters.size() ? parameters[index] : fallback;
+        };
+
+        if (name == "tictactoe")
+        {
+            const int rows = parameter(0, BOARD_SIZE);
+            return GameState(std::in_place_type<TicTacToe>, userIsStarting, rows, parameter(1, rows),
+                             parameter(2, BOARD_SIZE));
+        }
+        if (name == "connect4") return GameState(std::in_place_type<Connect4>, userIsStarting);
+        if (name == "sticks")
+        {
+            return GameState(std::in_place_type<SticksGame>, userIsStarting, parameter(0, STICKS_NUMBER),
+                             parameter(1, MAX_TAKE));
+        }
+        return std::nullopt;
+    }
+}
+
+/**
+ * @brief Constructs a server. Nothing happens until run() is called.
+ * @param options The settings of the server.
+ */
+GameServer::GameServer(const ServerOptions &options) : options(options) {}
+
+/**
+ * @brief Stops the workers and closes every socket.
+ */
+GameServer::~GameServer()
+{
+    stop();
+    for (auto &worker : workers) worker.join();
+    for (const auto &[id, connection] : connections) close(connection.socket);
+    for (const int fd : {listener, wakeRead, wakeWrite})
+    {
+        if (fd >= 0) close(fd);
+    }
+}
+
+/**
+ * @brief Makes run() return. May be called from any thread.
+ */
+void GameServer::stop()
+{
+    {
+        std::lock_guard lock(jobsMutex);
+        stopping = true;
+    }
+    jobsAvailable.notify_all();
+    wake();
+}
+
+/**
+ * @brief Wakes the network thread up.
+ */
+void GameServer::wake() const
+{
+    if (wakeWrite < 0) return;
+    const char byte = 0;
+    (void) !write(wakeWrite, &byte, 1); // A full pipe already wakes the thread up.
+}
+
+/**
+ * @brief Listens and serves clients until stop() is called.
+ * @return false if the server could not listen on its port, true once stopped.
+ */
+bool GameServer::run()
+{
+    listener = socket(AF_INET, SOCK_STREAM, 0);
+    if (listener < 0) return false;
+    const int reuse = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(options.port);
+    if (bind(listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0
+        || listen(listener, SOMAXCONN) != 0 || !setNonBlocking(listener))
+    {
+        return false;
+    }
+
+    int pipeEnds[2];
+    if (pipe(pipeEnds) != 0) return false;
+    wakeRead = pipeEnds[0];
+    wakeWrite = pipeEnds[1];
+    setNonBlocking(wakeRead);
+    setNonBlocking(wakeWrite);
+
+    for (int i = 0; i < std::max(1, options.workers); ++i)
+    {
+        workers.emplace_back([this] { work(); });
+    }
+
+    std::vector<pollfd> fds;
+    std::vector<uint64_t> ids;
+    while (!stopping)
+    {
+        fds.assign({{listener, POLLIN, 0}, {wakeRead, POLLIN, 0}});
+        ids.clear();
+        for (const auto &[id, connection] : connections)
+        {
+            fds.push_back({connection.socket, static_cast<short>(POLLIN | (connection.output.empty() ? 0 : POLLOUT)), 0});
+            ids.push_back(id);
+        }
+
+        if (poll(fds.data(), fds.size(), -1) < 0)
+        {
+            if (errno == EINTR) continue;
+            return false;
+        }
+
+        if (fds[1].revents & POLLIN)
+        {
+            char drain[256];
+            while (read(wakeRead, drain, sizeof(drain)) > 0) {}
+            deliverResults();
+        }
+        if (fds[0].revents & POLLIN) acceptConnections();
+
+        for (std::size_t i = 0; i < ids.size(); ++i)
+        {
+            const short events = fds[i + 2].revents;
+            if (events & (POLLIN | POLLHUP | POLLERR) && !readFrom(ids[i]))
+            {
+                Connection &connection = connections.at(ids[i]);
+                cancelSearches(connection);
+                close(connection.socket);
+                connections.erase(ids[i]);
+            }
+        }
+
+        for (auto it = connections.begin(); it != connections.end();)
+        {
+            if (!it->second.output.empty() && !writeTo(it->second))
+            {
+                cancelSearches(it->second);
+                close(it->second.socket);
+                it = connections.erase(it);
+            }
+            else ++it;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Accepts the pending connections.
+ */
+void GameServer::acceptConnections()
+{
+    while (true)
+    {
+        const int client = accept(listener, nullptr, nullptr);
+        if (client < 0) return;
+        if (!setNonBlocking(client))
+        {
+            close(client);
+            continue;
+        }
+        connections.emplace(nextConnection++, Connection{client});
+    }
+}
+
+/**
+ * @brief Reads from a client and executes its complete lines.
+ * @param id The number of the connection.
+ * @return false if the client disconnected, true otherwise.
+ */
+bool GameServer::readFrom(const uint64_t id)
+{
+    Connection &connection = connections.at(id);
+    char buffer[4096];
+    while (true)
+    {
+        const ssize_t received = recv(connection.socket, buffer, sizeof(buffer), 0);
+        if (received == 0) return false;
+        if (received < 0) return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+        connection.input.append(buffer, received);
+
+        std::size_t end;
+        while ((end = connection.input.find('\n')) != std::string::npos)
+        {
+            std::string line = connection.input.substr(0, end);
+            connection.input.erase(0, end + 1);
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            execute(id, connection, line);
+        }
+        if (connection.input.size() > MAX_LINE_LENGTH) return false;
+    }
+}
+
+/**
+ * @brief Sends as much of the pending output of a client as possible.
+ * @param connection The client.
+ * @return false if the connection failed, true otherwise.
+ */
+bool GameServer::writeTo(Connection &connection)
+{
+    while (!connection.output.empty())
+    {
+        const ssize_t sent = send(connection.socket, connection.output.data(), connection.output.size(), SEND_FLAGS);
+        if (sent < 0) return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+        connection.output.erase(0, sent);
+    }
+    return true;
+}
+
+/**
+ * @brief Executes one command of a client.
+ * @param id The number of the connection.
+ * @param connection The client.
+ * @param line The command.
+ */
+void GameServer::execute(const uint64_t id, Connection &connection, const std::string &line)
+{
+    std::istringstream in(line);
+    std::string command;
+    in >> command;
+    if (command.empty()) return;
+
+    if (command == "NEW")
+    {
+        std::string name, first = "you";
+        in >> name >> first;
+        std::vector<int> parameters;
+        for (int parameter; parameters.size() < 3 && in >> parameter;) parameters.push_back(parameter);
+
+        const int number = connection.nextSession;
+        try
+        {
+            std::optional<GameState> state = makeState(name, first != "ai", parameters);
+            if (!state)
+            {
+                connection.output += "ERR unknown game " + name + "\n";
+                return;
+            }
+            connection.sessions.emplace(number, Session{std::move(*state)});
+        }
+        catch (const std::invalid_argument &error)
+        {
+            connection.output += std::string("ERR ") + error.what() + "\n";
+            return;
+        }
+        ++connection.nextSession;
+        connection.output += "OK " + std::to_string(number) + "\n";
+        continueSession(id, connection, number, std::chrono::milliseconds(0));
+        return;
+    }
+
+    if (command != "PLAY" && command != "GO" && command != "MOVES" && command != "CLOSE")
+    {
+        connection.output += "ERR unknown command " + command + "\n";
+        return;
+    }
+
+    int number = 0;
+    in >> number;
+    const auto found = connection.sessions.find(number);
+    if (found == connection.sessions.end())
+    {
+        connection.output += "ERR unknown session\n";
+        return;
+    }
+    Session &session = found->second;
+
+    if (command == "PLAY")
+    {
+        int move = -1;
+        long deadline = 0;
+        in >> move >> deadline;
+        const bool legal = !session.searching && std::visit([&](auto &game)
+        {
+            MoveList moves;
+            game.generateMoves(moves);
+            return game.getCurrentPlayer() == game.PLAYER && !game.isTerminal()
+                && std::find(moves.begin(), moves.end(), move) != moves.end();
+        }, session.state);
+        if (!legal)
+        {
+            connection.output += "ERR illegal move\n";
+            return;
+        }
+        std::visit([&](auto &game) { game.makeMove(move); }, session.state);
+        continueSession(id, connection, number, std::chrono::milliseconds(deadline));
+    }
+    else if (command == "GO")
+    {
+        long deadline = 0;
+        in >> deadline;
+        if (!session.searching) continueSession(id, connection, number, std::chrono::milliseconds(deadline));
+    }
+    else if (command == "MOVES")
+    {
+        std::string response = "MOVES " + std::to_string(number);
+        std::visit([&](auto &game)
+        {
+            MoveList moves;
+            game.generateMoves(moves);
+            for (const auto move : moves)
+            {
+                response += ' ';
+                response += std::to_string(move);
+            }
+        }, session.state);
+        connection.output += response + "\n";
+    }
+    else
+    {
+        if (session.searching) session.cancelled->store(true);
+        connection.sessions.erase(found); // The result of a cancelled search is dropped.
+        connection.output += "OK " + std::to_string(number) + "\n";
+    }
+}
+
+/**
+ * @brief Queues the search of the AI's move in a session, or reports the end of its game.
+ * @param id The number of the connection.
+ * @param connection The client.
+ * @param number The number of the session.
+ * @param deadline The time the search may take, or 0 for no deadline.
+ */
+void GameServer::continueSession(const uint64_t id, Connection &connection, const int number,
+                                 const std::chrono::milliseconds deadline)
+{
+    Session &session = connection.sessions.at(number);
+    const auto [terminal, result, aiToMove] = std::visit([](const auto &game)
+    {
+        const int winner = game.getWinner();
+        const char* outcome = winner == game.PLAYER ? "win" : winner == game.AI ? "loss" : "draw";
+        return std::tuple(game.isTerminal(), outcome, game.getCurrentPlayer() == game.AI);
+    }, session.state);
+
+    if (terminal)
+    {
+        connection.output += "END " + std::to_string(number) + " " + result + "\n";
+        return;
+    }
+    if (!aiToMove) return;
+
+    {
+        std::lock_guard lock(jobsMutex);
+        if (jobs.size() >= options.queueCapacity)
+        {
+            connection.output += "BUSY " + std::to_string(number) + "\n";
+            return;
+        }
+        session.cancelled = std::make_shared<std::atomic<bool>>(false);
+        jobs.push_back({id, number, session.state, deadline, session.cancelled});
+    }
+    session.searching = true;
+    jobsAvailable.notify_one();
+}
+
+/**
+ * @brief Applies the completed searches to their sessions.
+ */
+void GameServer::deliverResults()
+{
+    std::vector<Result> completed;
+    {
+        std::lock_guard lock(resultsMutex);
+        completed.swap(results);
+    }
+
+    for (const Result &result : completed)
+    {
+        // The client may have disconnected or closed the session during the search.
+        const auto connection = connections.find(result.connection);
+        if (connection == connections.end()) continue;
+        const auto session = connection->second.sessions.find(result.session);
+        if (session == connection->second.sessions.end()) continue;
+
+        session->second.searching = false;
+        session->second.cancelled.reset();
+        std::visit([&](auto &game) { game.makeMove(result.move); }, session->second.state);
+        connection->second.output += "MOVE " + std::to_string(result.session) + " " + std::to_string(result.move) + "\n";
+        continueSession(result.connection, connection->second, result.session, std::chrono::milliseconds(0));
+    }
+}
+
+/**
+ * @brief Cancels the searches of every session of a client.
+ * @param connection The client.
+ */
+void GameServer::cancelSearches(Connection &connection)
+{
+    for (auto &[number, session] : connection.sessions)
+    {
+        if (session.searching) session.cancelled->store(true);
+    }
+}
+
+/**
+ * @brief Main loop of a worker: runs searches until the server stops.
+ *
+ * The worker keeps one engine per game for all the sessions it serves. An engine is cleared when
+ * it is given a game of another variant than its previous search, so that sessions with different
+ * board sizes, alignments or maximum takes never read each other's table entries.
+ */
+void GameServer::work()
+{
+    AlphaBeta<TicTacToe> ticTacToeEngine(options.ttSizeMb);
+    AlphaBeta<Connect4> connect4Engine(options.ttSizeMb);
+    AlphaBeta<SticksGame> sticksEngine(options.ttSizeMb);
+    std::string ticTacToeVariant;
+    std::string connect4Variant;
+    std::string sticksVariant;
+
+    const auto search = [this](auto &engine, std::string &variant, const auto &game, const Job &job)
+    {
+        using TGame = std::decay_t<decltype(game)>;
+        if (std::string gameVariant = game.getVariant(); gameVariant != variant)
+        {
+            engine.clear();
+            variant = std::move(gameVariant);
+        }
+
+        SearchLimits limits = SearchLimits::defaults<TGame>();
+        if (options.timeBudget.count() > 0) limits.timeBudget = options.timeBudget;
+
+        const auto deadline = job.deadline.count() > 0 ? std::chrono::steady_clock::now() + job.deadline
+                                                       : std::chrono::steady_clock::time_point::max();
+        AsyncSearch<TGame> asyncSearch(engine, game, limits);
+        while (asyncSearch.future().wait_for(CANCEL_CHECK_INTERVAL) != std::future_status::ready)
+        {
+            if (stopping || job.cancelled->load() || std::chrono::steady_clock::now() >= deadline) asyncSearch.cancel();
+        }
+        return asyncSearch.future().get().move;
+    };
+
+    while (true)
+    {
+        std::optional<Job> job;
+        {
+            std::unique_lock lock(jobsMutex);
+            jobsAvailable.wait(lock, [this] { return stopping || !jobs.empty(); });
+            if (stopping) return;
+            job.emplace(std::move(jobs.front()));
+            jobs.pop_front();
+        }
+
+        const int move = std::visit([&](auto &game)
+        {
+            using TGame = std::decay_t<decltype(game)>;
+            if constexpr (std::is_same_v<TGame, TicTacToe>) return search(ticTacToeEngine, ticTacToeVariant, game, *job);
+            else if constexpr (std::is_same_v<TGame, Connect4>) return search(connect4Engine, connect4Variant, game, *job);
+            else return search(sticksEngine, sticksVariant, game, *job);
+        }, job->state);
+
+        {
+            std::lock_guard lock(resultsMutex);
+            results.push_back({job->connection, job->session, move});
+        }
+        wake();
+    }
+}
@@ -0,0 +1,431 @@
+/**
+ * @file OpeningBook.cpp
+ * @brief Implementation of the memory-mapped opening book.
+ */
+
+#include "OpeningBook.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#ifdef _WIN32
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    constexpr char MAGIC[8] = {'M', 'M', 'B', 'O', 'O', 'K', '\0', '\0'}; ///< Identifies a book file.
+    constexpr uint32_t BLOCK_SIZE = 64; ///< The number of records per block of a compressed book.
+
+    /**
+     * @struct BookHeader
+     * @brief The header at the beginning of a book file.
+     */
+    struct BookHeader {
+        char magic[8];  ///< Always MAGIC.
+        uint32_t version; ///< The format version, a BookFormat.
+        uint32_t reserved; ///< Always 0.
+        uint64_t count; ///< The number of records in the book.
+    };
+
+    /**
+     * @struct BlockHeader
+     * @brief The header following BookHeader in a compressed book.
+     */
+    struct BlockHeader {
+        uint32_t blockSize; ///< The number of records per block, except in the last block.
+        uint32_t blockCount; ///< The number of blocks, each with an entry in the block index.
+    };
+
+    /**
+     * @struct BookRecord
+     * @brief The record of one position in a flat book.
+     */
+    struct BookRecord {
+        uint64_t key; ///< The Zobrist hash of the position.
+        int16_t score; ///< The score of the position.
+        int16_t move; ///< The best move of the position.
+        uint32_t reserved; ///< Always 0.
+    };
+
+    /**
+     * @struct BlockIndexEntry
+     * @brief The entry of one block in the block index of a compressed book.
+     */
+    struct BlockIndexEntry {
+        uint64_t firstKey; ///< The key of the first record of the block.
+        uint64_t offset; ///< The offset of the block from the end of the block index.
+    };
+
+    static_assert(sizeof(BookHeader) == 24, "The header layout is part of the file format");
+    static_assert(sizeof(BlockHeader) == 8, "The header layout is part of the file format");
+    static_assert(sizeof(BookRecord) == 16, "The record layout is part of the file format");
+    static_assert(sizeof(BlockIndexEntry) == 16, "The index layout is part of the file format");
+
+    constexpr std::size_t COMPRESSED_HEADER_SIZE = sizeof(BookHeader) + sizeof(BlockHeader); ///< Where the block index starts.
+
+    /**
+     * @brief Appends an unsigned number in LEB128 encoding: 7 bits per byte, low bits first.
+     * @param out The bytes to append to.
+     * @param value The number.
+     */
+    void putVarint(std::vector<unsigned char> &out, uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            out.push_back(static_cast<unsigned char>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<unsigned char>(value));
+    }
+
+    /**
+     * @brief Reads an unsigned number in LEB128 encoding.
+     * @param in The next byte to read, advanced past the number.
+     * @param end The end of the readable bytes.
+     * @param value Receives the number.
+     * @return true if a complete number was read, false if the bytes ran out.
+     */
+    bool getVarint(const unsigned char* &in, const unsigned char* end, uint64_t &value)
+    {
+        value = 0;
+        for (int shift = 0; in < end && shift < 64; shift += 7)
+        {
+            const unsigned char byte = *in++;
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Maps a signed number to an unsigned one, small magnitudes first (0, -1, 1, -2...).
+     * @param value The signed number.
+     * @return The zigzag encoding of the number.
+     */
+    uint64_t zigzag(const int value)
+    {
+        return value >= 0 ? static_cast<uint64_t>(value) << 1 : (static_cast<uint64_t>(-(value + 1)) << 1) | 1;
+    }
+
+    /**
+     * @brief Inverts zigzag().
+     * @param value The zigzag encoding of a number.
+     * @return The signed number.
+     */
+    int unzigzag(const uint64_t value)
+    {
+        return value & 1 ? -static_cast<int>(value >> 1) - 1 : static_cast<int>(value >> 1);
+    }
+
+    /**
+     * @brief Appends the score and move of a record to a compressed block.
+     * @param out The bytes to append to.
+     * @param entry The record.
+     */
+    void putPayload(std::vector<unsigned char> &out, const BookEntry &entry)
+    {
+        putVarint(out, zigzag(entry.score));
+        putVarint(out, static_cast<uint64_t>(entry.move + 1)); // -1, no move, becomes 0.
+    }
+
+    /**
+     * @brief Reads the score and move of a record from a compressed block.
+     * @param in The next byte to read, advanced past the record.
+     * @param end The end of the block.
+     * @param entry Receives the score and move.
+     * @return true if the record was complete, false otherwise.
+     */
+    bool getPayload(const unsigned char* &in, const unsigned char* end, BookEntry &entry)
+    {
+        uint64_t score, move;
+        if (!getVarint(in, end, score) || !getVarint(in, end, move)) return false;
+        entry.score = static_cast<int16_t>(unzigzag(score));
+        entry.move = static_cast<int16_t>(static_cast<int>(move) - 1);
+        return true;
+    }
+}
+
+/**
+ * @brief Constructs a book and opens a file.
+ * @param path The path of the book file. Check isOpen() to know whether it could be opened.
+ */
+OpeningBook::OpeningBook(const std::string &path)
+{
+    open(path);
+}
+
+/**
+ * @brief Unmaps the file.
+ */
+OpeningBook::~OpeningBook()
+{
+    close();
+}
+
+/**
+ * @brief Maps a book file, replacing the book currently open.
+ * @param path The path of the book file.
+ * @return true if the file is a valid book, false otherwise.
+ */
+bool OpeningBook::open(const std::string &path)
+{
+    close();
+
+#ifdef _WIN32
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+    buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    data = buffer.data();
+    dataSize = buffer.size();
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat status{};
+    if (fstat(fd, &status) != 0 || status.st_size < static_cast<off_t>(sizeof(BookHeader)))
+    {
+        ::close(fd);
+        return false;
+    }
+
+    void* mapping = mmap(nullptr, status.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd); // The mapping stays valid once the file is closed.
+    if (mapping == MAP_FAILED) return false;
+
+    data = static_cast<const unsigned char*>(mapping);
+    dataSize = status.st_size;
+#endif
+
+    return validate();
+}
+
+/**
+ * @brief Checks the header of the mapped file, and closes the book if it is invalid.
+ * @return true if the file is a valid book, false otherwise.
+ */
+bool OpeningBook::validate()
+{
+    BookHeader header{};
+    bool valid = dataSize >= sizeof(header);
+    if (valid)
+    {
+        std::memcpy(&header, data, sizeof(header));
+        valid = std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0;
+    }
+
+    if (valid && header.version == static_cast<uint32_t>(BookFormat::Flat))
+    {
+        valid = (dataSize - sizeof(header)) % sizeof(BookRecord) == 0
+             && header.count == (dataSize - sizeof(header)) / sizeof(BookRecord);
+        blockCount = 0;
+    }
+    else if (valid && header.version == static_cast<uint32_t>(BookFormat::Compressed))
+    {
+        BlockHeader blocks{};
+        valid = dataSize >= COMPRESSED_HEADER_SIZE;
+        if (valid)
+        {
+            std::memcpy(&blocks, data + sizeof(header), sizeof(blocks));
+            const uint64_t dataStart = COMPRESSED_HEADER_SIZE + static_cast<uint64_t>(blocks.blockCount) * sizeof(BlockIndexEntry);
+            valid = blocks.blockSize > 0 && dataStart <= dataSize && header.count <= dataSize // A record takes at least two bytes.
+                 && static_cast<uint64_t>(blocks.blockCount) == (header.count + blocks.blockSize - 1) / blocks.blockSize;
+
+            // Every block must lie inside the file, so that probes never read past the mapping.
+            const auto* index = reinterpret_cast<const BlockIndexEntry*>(data + COMPRESSED_HEADER_SIZE);
+            for (uint32_t i = 0; valid && i < blocks.blockCount; ++i)
+            {
+                valid = index[i].offset <= dataSize - dataStart && (i == 0 || index[i].offset >= index[i - 1].offset);
+            }
+
+            // The last block ends with the file, so a truncated file is caught by decoding it.
+            if (valid && blocks.blockCount > 0)
+            {
+                const uint64_t lastCount = header.count - static_cast<uint64_t>(blocks.blockCount - 1) * blocks.blockSize;
+                const unsigned char* in = data + dataStart + index[blocks.blockCount - 1].offset;
+                const unsigned char* end = data + dataSize;
+                for (uint64_t i = 0; valid && i < lastCount; ++i)
+                {
+                    uint64_t delta = 0;
+                    BookEntry record;
+                    valid = (i == 0 || getVarint(in, end, delta)) && getPayload(in, end, record);
+                }
+                valid = valid && in == end;
+            }
+        }
+        blockCount = blocks.blockCount;
+    }
+    else valid = false;
+
+    if (!valid)
+    {
+        close();
+        return false;
+    }
+
+    format = static_cast<BookFormat>(header.version);
+    recordCount = header.count;
+    return true;
+}
+
+/**
+ * @brief Unmaps the file. The book then contains no position.
+ */
+void OpeningBook::close()
+{
+#ifdef _WIN32
+    buffer.clear();
+#else
+    if (data) munmap(const_cast<unsigned char*>(data), dataSize);
+#endif
+    data = nullptr;
+    dataSize = 0;
+    recordCount = 0;
+    blockCount = 0;
+}
+
+/**
+ * @brief Checks whether a book is open.
+ * @return true if a valid book file is mapped, false otherwise.
+ */
+bool OpeningBook::isOpen() const
+{
+    return data != nullptr;
+}
+
+/**
+ * @brief Gets the number of positions in the book.
+ * @return The number of records.
+ */
+std::size_t OpeningBook::size() const
+{
+    return recordCount;
+}
+
+/**
+ * @brief Looks up a position.
+ * @param key The Zobrist hash of the position.
+ * @param entry Receives the record of the position when it is found.
+ * @return true if the position is in the book, false otherwise.
+ */
+bool OpeningBook::probe(const uint64_t key, BookEntry &entry) const
+{
+    if (!data) return false;
+    return format == BookFormat::Flat ? probeFlat(key, entry) : probeCompressed(key, entry);
+}
+
+/**
+ * @brief Looks up a position in a flat book.
+ * @param key The Zobrist hash of the position.
+ * @param entry Receives the record of the position when it is found.
+ * @return true if the position is in the book, false otherwise.
+ */
+bool OpeningBook::probeFlat(const uint64_t key, BookEntry &entry) const
+{
+    // The records follow the header, which keeps them 8-byte aligned in the page-aligned mapping.
+    const auto* records = reinterpret_cast<const BookRecord*>(data + sizeof(BookHeader));
+    const BookRecord* end = records + recordCount;
+    const BookRecord* found = std::lower_bound(records, end, key,
+        [](const BookRecord &record, const uint64_t value) { return record.key < value; });
+    if (found == end || found->key != key) return false;
+
+    entry.key = found->key;
+    entry.score = found->score;
+    entry.move = found->move;
+    return true;
+}
+
+/**
+ * @brief Looks up a position in a compressed book.
+ * @param key The Zobrist hash of the position.
+ * @param entry Receives the record of the position when it is found.
+ * @return true if the position is in the book, false otherwise.
+ */
+bool OpeningBook::probeCompressed(const uint64_t key, BookEntry &entry) const
+{
+    const auto* index = reinterpret_cast<const BlockIndexEntry*>(data + COMPRESSED_HEADER_SIZE);
+    const unsigned char* blocks = data + COMPRESSED_HEADER_SIZE + blockCount * sizeof(BlockIndexEntry);
+
+    // The block holding the key is the last one starting at or before it.
+    const BlockIndexEntry* next = std::upper_bound(index, index + blockCount, key,
+        [](const uint64_t value, const BlockIndexEntry &block) { return value < block.firstKey; });
+    if (next == index) return false;
+    const BlockIndexEntry* block = next - 1;
+
+    const unsigned char* in = blocks + block->offset;
+    const unsigned char* end = next == index + blockCount ? data + dataSize : blocks + next->offset;
+
+    // The first key is in the index, the others are deltas from their predecessor.
+    uint64_t current = block->firstKey;
+    for (bool first = true; in < end; first = false)
+    {
+        uint64_t delta = 0;
+        if (!first && !getVarint(in, end, delta)) return false;
+        current += delta;
+        if (current > key) return false;
+
+        BookEntry record;
+        if (!getPayload(in, end, record)) return false;
+        if (current == key)
+        {
+            entry = record;
+            entry.key = key;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Writes a book file.
+ * @param path The path of the file to create.
+ * @param entries The positions of the book, in any order. Only the first record of a hash is kept.
+ * @param format The layout of the file.
+ * @return true if the file was written, false otherwise.
+ */
+bool OpeningBook::write(const std::string &path, std::vector<BookEntry> entries, const BookFormat format)
+{
+    std::stable_sort(entries.begin(), entries.end(),
+        [](const BookEntry &a, const BookEntry &b) { return a.key < b.key; });
+    entries.erase(std::unique(entries.begin(), entries.end(),
+        [](const BookEntry &a, const BookEntry &b) { return a.key == b.key; }), entries.end());
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) return false;
+
+    BookHeader header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = static_cast<uint32_t>(format);
+    header.count = entries.size();
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    if (format == BookFormat::Flat)
+    {
+        for (const BookEntry &entry : entries)
+        {
+            const BookRecord record{entry.key, entry.score, entry.move, 0};
+            file.write(reinterpret_cast<const char*>(&record), sizeof(record));
+        }
+        return static_cast<bool>(file);
+    }
+
+    std::vector<BlockIndexEntry> index;
+    std::vector<unsigned char> blocks;
+    for (std::size_t i = 0; i < entries.size(); ++i)
+    {
+        if (i % BLOCK_SIZE == 0) index.push_back({entries[i].key, blocks.size()});
+        else putVarint(blocks, entries[i].key - entries[i - 1].key);
+        putPayload(blocks, entries[i]);
+    }
+
+    const BlockHeader blockHeader{BLOCK_SIZE, static_cast<uint32_t>(index.size())};
+    file.write(reinterpret_cast<const char*>(&blockHeader), sizeof(blockHeader));
+    file.write(reinterpret_cast<const char*>(index.data()), static_cast<std::streamsize>(index.size() * sizeof(BlockIndexEntry)));
+    file.write(reinterpret_cast<const char*>(blocks.data()), static_cast<std::streamsize>(blocks.size()));
+    return static_cast<bool>(file);
+}
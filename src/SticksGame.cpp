@@ -4,6 +4,82 @@
  */
 
 #include "SticksGame.h"
+#include "Zobrist.h"
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+    constexpr uint64_t TAKE_KEY_SEED = 4500; ///< Index of the key of a maximum take of 0, below the keys of the heaps.
+    constexpr uint64_t STICKS_KEY_SEED = 5000; ///< Index of the key of an empty heap.
+    constexpr int MAX_DRAWN_STICKS = 60; ///< Larger heaps are displayed as a number only.
+
+    /**
+     * @brief Gets the Zobrist key of a number of remaining sticks.
+     * @param sticks The number of remaining sticks.
+     * @return The key of the stick count.
+     */
+    constexpr uint64_t sticksKey(const int sticks)
+    {
+        return Zobrist::key(STICKS_KEY_SEED + sticks);
+    }
+
+    /**
+     * @brief Gets the Zobrist key of a maximum take.
+     *
+     * It stays in the hash for the whole game, so the positions of games with different maximum
+     * takes do not share their hashes, nor their entries in a transposition table.
+     * @param maxTake The maximum number of sticks removed in one move.
+     * @return The key of the maximum take.
+     */
+    constexpr uint64_t takeKey(const int maxTake)
+    {
+        return Zobrist::key(TAKE_KEY_SEED + maxTake);
+    }
+}
+
+/**
+ * @brief Constructs a SticksGame instance.
+ * @param userIsStarting Determines whether the user starts the game. Defaults to `true`.
+ * @param sticks The initial number of sticks, at least 1.
+ * @param maxTake The maximum number of sticks removed in one move, between 1 and `MAX_TAKE_LIMIT`.
+ * @throws std::invalid_argument If a parameter is out of range.
+ */
+SticksGame::SticksGame(const bool userIsStarting, const int sticks, const int maxTake)
+    : currentPlayer(userIsStarting ? PLAYER : AI), remainingSticks(sticks), maxTake(maxTake),
+      hash(sticksKey(sticks) ^ takeKey(maxTake) ^ (userIsStarting ? 0 : Zobrist::SIDE_KEY))
+{
+    if (sticks < 1) throw std::invalid_argument("The game needs at least one stick");
+    if (maxTake < 1 || maxTake > MAX_TAKE_LIMIT) throw std::invalid_argument("The maximum take must be between 1 and " + std::to_string(MAX_TAKE_LIMIT));
+}
+
+/**
+ * @brief Gets the number of sticks remaining in the game.
+ * @return The number of remaining sticks.
+ */
+int SticksGame::getRemainingSticks() const
+{
+    return remainingSticks;
+}
+
+/**
+ * @brief Gets the maximum number of sticks removed in one move.
+ * @return The maximum take.
+ */
+int SticksGame::getMaxTake() const
+{
+    return maxTake;
+}
+
+/**
+ * @brief Gets the parameters of the game not given by its type, shared by the positions of the same variant.
+ * @return The maximum take. The other positions of the game only have fewer sticks.
+ */
+std::string SticksGame::getVariant() const
+{
+    return std::to_string(maxTake);
+}
 
 /**
  * @brief Gets the current player in the game.
@@ -20,7 +96,7 @@ int SticksGame::getCurrentPlayer() const
 void SticksGame::display() const
 {
     std::cout << "Remaining sticks: " << remainingSticks << "\n";
-    for (int i = 0; i < remainingSticks; ++i)
+    for (int i = 0; i < remainingSticks && remainingSticks <= MAX_DRAWN_STICKS; ++i)
     {
         std::cout << "| ";
     }
@@ -38,16 +114,35 @@ bool SticksGame::isTerminal() const
 
 /**
  * @brief Gets all the valid moves available in the current game state.
- * @return A vector of integers representing the number of sticks that can be removed (1, 2, or 3).
+ * @return A vector of integers representing the number of sticks that can be removed (1 to the maximum take).
  */
 std::vector<int> SticksGame::getAvailableMoves() const
 {
-    std::vector<int> moves;
-    for (int numSticks = 1; numSticks <= 3 && numSticks <= remainingSticks; ++numSticks)
+    MoveList moves;
+    generateMoves(moves);
+    return {moves.begin(), moves.end()};
+}
+
+/**
+ * @brief Writes all the valid moves into a move list.
+ * @param moves The list to fill with the numbers of sticks that can be removed (1 to the maximum take).
+ */
+void SticksGame::generateMoves(MoveList &moves) const
+{
+    moves.clear();
+    for (int numSticks = 1; numSticks <= maxTake && numSticks <= remainingSticks; ++numSticks)
     {
-        moves.emplace_back(numSticks); // Use numSticks as the number of sticks to remove
+        moves.add(numSticks); // Use numSticks as the number of sticks to remove
     }
-    return moves;
+}
+
+/**
+ * @brief Checks if at least one stick remains.
+ * @return true if a move can be made, false otherwise.
+ */
+bool SticksGame::hasMoves() const
+{
+    return remainingSticks > 0;
 }
 
 /**
@@ -56,6 +151,7 @@ std::vector<int> SticksGame::getAvailableMoves() const
  */
 void SticksGame::makeMove(const int numSticks)
 {
+    hash ^= sticksKey(remainingSticks) ^ sticksKey(remainingSticks - numSticks) ^ Zobrist::SIDE_KEY;
     remainingSticks -= numSticks;
     currentPlayer = (currentPlayer == PLAYER) ? AI : PLAYER; // Switch turns
 }
@@ -66,6 +162,7 @@ void SticksGame::makeMove(const int numSticks)
  */
 void SticksGame::undoMove(const int numSticks)
 {
+    hash ^= sticksKey(remainingSticks) ^ sticksKey(remainingSticks + numSticks) ^ Zobrist::SIDE_KEY;
     remainingSticks += numSticks;
     currentPlayer = (currentPlayer == PLAYER) ? AI : PLAYER; // Switch turns back
 }
@@ -94,14 +191,83 @@ int SticksGame::getWinner() const
     return 0;
 }
 
+/**
+ * @brief Gets the Zobrist hash of the current game state.
+ * @return A 64-bit hash of the remaining sticks, of the maximum take and of the player to move.
+ */
+uint64_t SticksGame::getHash() const
+{
+    return hash;
+}
+
+/**
+ * @brief Gets the hash shared by the symmetric positions. The game has no symmetry.
+ * @return The hash of the game state.
+ */
+uint64_t SticksGame::getCanonicalHash() const
+{
+    return hash;
+}
+
+/**
+ * @brief Maps a move to the canonical image of the position, the position itself.
+ * @param move The move.
+ * @return The same move.
+ */
+int SticksGame::toCanonicalMove(const int move) const
+{
+    return move;
+}
+
+/**
+ * @brief Maps a move of the canonical image back to the position, the position itself.
+ * @param move The move.
+ * @return The same move.
+ */
+int SticksGame::fromCanonicalMove(const int move) const
+{
+    return move;
+}
+
+/**
+ * @brief Encodes the game state as a line of text.
+ * @return The remaining sticks, the player to move and the maximum take.
+ */
+std::string SticksGame::toString() const
+{
+    return std::to_string(remainingSticks) + (currentPlayer == PLAYER ? " X " : " O ") + std::to_string(maxTake);
+}
+
+/**
+ * @brief Decodes a game state encoded by toString().
+ *
+ * A game without sticks is over: it is reached by taking the last stick of a one-stick game.
+ * @param text The encoding: the number of remaining sticks, then the player to move, `X` or
+ *             `O`, then the maximum number of sticks taken per move. For instance `21 X 3`.
+ * @return The game, or nothing if the text is not a valid game state.
+ */
+std::optional<SticksGame> SticksGame::fromString(const std::string &text)
+{
+    std::istringstream input(text);
+    std::string side, extra;
+    int sticks, take;
+    if (!(input >> sticks >> side >> take) || input >> extra || (side != "X" && side != "O")) return std::nullopt;
+    if (sticks < 0 || take < 1 || take > MAX_TAKE_LIMIT) return std::nullopt;
+
+    if (sticks > 0) return SticksGame(side == "X", sticks, take);
+    SticksGame game(side != "X", 1, take);
+    game.makeMove(1);
+    return game;
+}
+
 /**
  * @brief Checks if the player's input is valid.
  * @param input The number of sticks the player wants to pick.
- * @return true if the input is valid (1-3 sticks and within remaining sticks), false otherwise.
+ * @return true if the input is valid (1 to the maximum take and within remaining sticks), false otherwise.
  */
 bool SticksGame::checkInput(const int input) const
 {
-    return input >= 1 && input <= 3 && input <= remainingSticks;
+    return input >= 1 && input <= maxTake && input <= remainingSticks;
 }
 
 /**
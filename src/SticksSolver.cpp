@@ -0,0 +1,54 @@
+/**
+ * @file SticksSolver.cpp
+ * @brief Implementation of the dynamic programming solver of the Sticks game.
+ */
+
+#include "SticksSolver.h"
+
+/**
+ * @brief Solves every stick count up to a maximum.
+ * @param maxSticks The largest number of sticks to solve.
+ * @param maxTake The maximum number of sticks removed in one move, between 1 and `MAX_TAKE_LIMIT`.
+ */
+SticksSolver::SticksSolver(const int maxSticks, const int maxTake)
+    : maxTake(maxTake), winningTake(maxSticks + 1, 0)
+{
+    // With no stick left, the opponent took the last one: the player to move has won.
+    // The table only stores takes, so 0 sticks is marked won by a take that can never be played.
+    winningTake[0] = 1;
+    for (int sticks = 1; sticks <= maxSticks; ++sticks)
+    {
+        for (int take = 1; take <= maxTake && take <= sticks; ++take)
+        {
+            if (!winningTake[sticks - take])
+            {
+                winningTake[sticks] = static_cast<uint16_t>(take);
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Checks whether the player to move wins with perfect play.
+ * @param sticks The number of remaining sticks, at most the solved maximum.
+ * @return true if the player to move wins, false otherwise.
+ */
+bool SticksSolver::isWinning(const int sticks) const
+{
+    return winningTake[sticks] != 0;
+}
+
+/**
+ * @brief Gets the best move of a game.
+ *
+ * In a lost position, the smallest take is returned, leaving the opponent the most chances to err.
+ * @param game The game. Its maximum take must be the one solved.
+ * @return The number of sticks to take, or -1 if the game is over or was not solved.
+ */
+int SticksSolver::getBestMove(const SticksGame &game) const
+{
+    const int sticks = game.getRemainingSticks();
+    if (sticks <= 0 || sticks >= static_cast<int>(winningTake.size()) || game.getMaxTake() != maxTake) return -1;
+    return winningTake[sticks] ? winningTake[sticks] : 1;
+}
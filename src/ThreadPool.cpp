@@ -0,0 +1,63 @@
+/**
+ * @file ThreadPool.cpp
+ * @brief Implementation of a fixed-size pool of worker threads.
+ */
+
+#include "ThreadPool.h"
+#include <algorithm>
+
+/**
+ * @brief Starts the worker threads.
+ * @param threadCount The number of worker threads. At least one thread is started.
+ */
+ThreadPool::ThreadPool(const unsigned threadCount)
+{
+    for (unsigned i = 0; i < std::max(threadCount, 1u); ++i)
+    {
+        workers.emplace_back([this] { run(); });
+    }
+}
+
+/**
+ * @brief Finishes the queued tasks and joins the worker threads.
+ */
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+    available.notify_all();
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+}
+
+/**
+ * @brief Gets the number of worker threads.
+ * @return The number of worker threads.
+ */
+unsigned ThreadPool::size() const
+{
+    return static_cast<unsigned>(workers.size());
+}
+
+/**
+ * @brief Main loop of a worker thread: runs tasks until the pool stops.
+ */
+void ThreadPool::run()
+{
+    while (true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock lock(mutex);
+            available.wait(lock, [this] { return stopping || !tasks.empty(); });
+            if (tasks.empty()) return; // Stopping, and nothing left to do.
+            task = std::move(tasks.front());
+            tasks.pop();
+        }
+        task();
+    }
+}
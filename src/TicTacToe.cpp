@@ -4,17 +4,277 @@
  */
 
 #include "TicTacToe.h"
+#include "Zobrist.h"
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+
+namespace
+{
+    /// Zobrist keys of the PLAYER markers, indexed by cell.
+    constexpr auto PLAYER_KEYS = Zobrist::makeKeys<MAX_CELLS>(3000);
+    /// Zobrist keys of the AI markers, indexed by cell.
+    constexpr auto AI_KEYS = Zobrist::makeKeys<MAX_CELLS>(4000);
+    /// Index of the first key of a board size, far from the other tables.
+    constexpr uint64_t SHAPE_KEY_SEED = uint64_t{1} << 48;
+
+    /**
+     * @brief Gets the Zobrist key of a board size and of its alignment.
+     *
+     * It stays in the hashes for the whole game, so boards of different sizes or alignments do not
+     * share their hashes, nor their entries in a transposition table, when their markers are the same.
+     * @param rows The number of rows.
+     * @param columns The number of columns.
+     * @param alignment The number of aligned markers winning the game.
+     * @return The key of the board size.
+     */
+    constexpr uint64_t shapeKey(const int rows, const int columns, const int alignment)
+    {
+        const uint64_t index = (static_cast<uint64_t>(rows) * (MAX_CELLS + 1) + columns) * (MAX_CELLS + 1) + alignment;
+        return Zobrist::key(SHAPE_KEY_SEED + index);
+    }
+
+    /// The directions of the lines, as (row, column) steps: horizontal, vertical and both diagonals.
+    constexpr int DIRECTIONS[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+
+    /**
+     * @brief Gets the score of a line, from the AI's point of view.
+     *
+     * Only a line holding the markers of a single player can still be completed, and each additional
+     * marker is worth four times more. A full line is a win, scored by evaluate().
+     * @param aiMarkers The number of AI markers in the line.
+     * @param playerMarkers The number of PLAYER markers in the line.
+     * @return The score of the line.
+     */
+    int lineScoreOf(const int aiMarkers, const int playerMarkers)
+    {
+        if (aiMarkers > 0 && playerMarkers == 0) return 1 << std::min(2 * (aiMarkers - 1), 12);
+        if (playerMarkers > 0 && aiMarkers == 0) return -(1 << std::min(2 * (playerMarkers - 1), 12));
+        return 0;
+    }
+}
 
 /**
  * @brief Constructs a TicTacToe game instance.
  * @param userIsStarting A boolean indicating if the user is the starting player.
+ * @param rows The number of rows, at least 1.
+ * @param columns The number of columns, at least 1. The board has at most `MAX_CELLS` cells.
+ * @param alignment The number of aligned markers winning the game, between 1 and the larger dimension.
+ * @throws std::invalid_argument If a parameter is out of range.
+ */
+TicTacToe::TicTacToe(const bool userIsStarting, const int rows, const int columns, const int alignment)
+    : currentPlayer(userIsStarting ? PLAYER : AI)
+{
+    hashes.fill(shapeKey(rows, columns, alignment) ^ (userIsStarting ? 0 : Zobrist::SIDE_KEY));
+    if (rows < 1 || columns < 1 || rows * columns > MAX_CELLS)
+    {
+        throw std::invalid_argument("The board must have between 1 and " + std::to_string(MAX_CELLS) + " cells");
+    }
+    if (alignment < 1 || alignment > std::max(rows, columns))
+    {
+        throw std::invalid_argument("The alignment must be between 1 and the size of the board");
+    }
+    geometry = geometryOf(rows, columns, alignment);
+}
+
+/**
+ * @brief Gets the masks of a board size, computed on its first use.
+ *
+ * The masks of every size played are kept in a table until the program exits, so the games only
+ * hold a pointer to them, which stays valid when they are copied to other threads.
+ * @param rows The number of rows.
+ * @param columns The number of columns.
+ * @param alignment The number of aligned markers winning the game.
+ * @return The masks of the board, kept until the program exits.
+ */
+const TicTacToe::Geometry* TicTacToe::geometryOf(const int rows, const int columns, const int alignment)
+{
+    static std::mutex mutex;
+    static std::map<std::tuple<int, int, int>, std::unique_ptr<const Geometry>> geometries;
+
+    std::lock_guard lock(mutex);
+    auto &geometry = geometries[{rows, columns, alignment}];
+    if (!geometry) geometry = std::make_unique<const Geometry>(makeGeometry(rows, columns, alignment));
+    return geometry.get();
+}
+
+/**
+ * @brief Computes the masks of a board size.
+ * @param rows The number of rows.
+ * @param columns The number of columns.
+ * @param alignment The number of aligned markers winning the game.
+ * @return The masks of the board.
  */
-TicTacToe::TicTacToe(const bool userIsStarting) : board() , currentPlayer(userIsStarting ? PLAYER : AI) {
-    for (auto & row : board) {
-        for (int & cell : row) {
-            cell = EMPTY;
+TicTacToe::Geometry TicTacToe::makeGeometry(const int rows, const int columns, const int alignment)
+{
+    Geometry geometry;
+    geometry.rows = rows;
+    geometry.columns = columns;
+    geometry.alignment = alignment;
+    geometry.lineCount = 0;
+    geometry.cellLines.resize(rows * columns);
+
+    const auto inside = [&](const int row, const int column)
+    {
+        return row >= 0 && row < rows && column >= 0 && column < columns;
+    };
+
+    for (int row = 0; row < rows; ++row)
+    {
+        for (int column = 0; column < columns; ++column)
+        {
+            // Each line is listed once, from its first cell.
+            for (const auto &[rowStep, columnStep] : DIRECTIONS)
+            {
+                if (!inside(row + (alignment - 1) * rowStep, column + (alignment - 1) * columnStep)) continue;
+                if (alignment == 1 && (rowStep != 0 || columnStep != 1)) continue;
+
+                for (int i = 0; i < alignment; ++i)
+                {
+                    geometry.cellLines[(row + i * rowStep) * columns + column + i * columnStep].push_back(
+                        static_cast<uint16_t>(geometry.lineCount));
+                }
+                ++geometry.lineCount;
+            }
+
+            Bitboard neighborhood;
+            for (int r = row - CANDIDATE_DISTANCE; r <= row + CANDIDATE_DISTANCE; ++r)
+            {
+                for (int c = column - CANDIDATE_DISTANCE; c <= column + CANDIDATE_DISTANCE; ++c)
+                {
+                    if (inside(r, c)) neighborhood.set(r * columns + c);
+                }
+            }
+            geometry.neighborhoods.push_back(neighborhood);
+        }
+    }
+
+    // Symmetry s mirrors the rows if bit 0 is set, then the columns if bit 1 is set, then
+    // transposes the board if bit 2 is set, which only a square board allows.
+    geometry.symmetryCount = rows == columns ? MAX_SYMMETRIES : MAX_SYMMETRIES / 2;
+    for (int symmetry = 0; symmetry < geometry.symmetryCount; ++symmetry)
+    {
+        geometry.images[symmetry].resize(rows * columns);
+        geometry.preimages[symmetry].resize(rows * columns);
+        for (int row = 0; row < rows; ++row)
+        {
+            for (int column = 0; column < columns; ++column)
+            {
+                int imageRow = symmetry & 1 ? rows - 1 - row : row;
+                int imageColumn = symmetry & 2 ? columns - 1 - column : column;
+                if (symmetry & 4) std::swap(imageRow, imageColumn);
+                const int cell = row * columns + column;
+                const int image = imageRow * columns + imageColumn;
+                geometry.images[symmetry][cell] = static_cast<uint16_t>(image);
+                geometry.preimages[symmetry][image] = static_cast<uint16_t>(cell);
+            }
         }
     }
+    return geometry;
+}
+
+/**
+ * @brief Adds or removes a marker in the lines through a cell.
+ * @param cellIndex The cell of the marker.
+ * @param isPlayer Whether the marker belongs to PLAYER.
+ * @param delta 1 to add the marker, -1 to remove it.
+ */
+void TicTacToe::updateLines(const int cellIndex, const bool isPlayer, const int delta)
+{
+    auto &markers = isPlayer ? playerLineMarkers : aiLineMarkers;
+    int &fullLines = isPlayer ? playerLines : aiLines;
+    for (const uint16_t line : geometry->cellLines[cellIndex])
+    {
+        lineScore -= lineScoreOf(aiLineMarkers[line], playerLineMarkers[line]);
+        if (markers[line] == geometry->alignment) --fullLines;
+        markers[line] = static_cast<uint8_t>(markers[line] + delta);
+        if (markers[line] == geometry->alignment) ++fullLines;
+        lineScore += lineScoreOf(aiLineMarkers[line], playerLineMarkers[line]);
+    }
+}
+
+/**
+ * @brief Toggles a marker in the hashes of the board and of its images.
+ *
+ * The image by a symmetry holds the marker on the image of the cell.
+ * @param cellIndex The cell of the marker.
+ * @param isPlayer Whether the marker belongs to PLAYER.
+ */
+void TicTacToe::toggleHashes(const int cellIndex, const bool isPlayer)
+{
+    const auto &keys = isPlayer ? PLAYER_KEYS : AI_KEYS;
+    hashes[0] ^= keys[cellIndex] ^ Zobrist::SIDE_KEY;
+    for (int symmetry = 1; symmetry < geometry->symmetryCount; ++symmetry)
+    {
+        hashes[symmetry] ^= keys[geometry->images[symmetry][cellIndex]] ^ Zobrist::SIDE_KEY;
+    }
+}
+
+/**
+ * @brief Finds the symmetry giving the canonical image of the board.
+ *
+ * Ties, as on a symmetric board, are broken in favor of the first symmetry, the identity first.
+ * @return The symmetry whose image has the smallest hash.
+ */
+int TicTacToe::canonicalSymmetry() const
+{
+    int best = 0;
+    for (int symmetry = 1; symmetry < geometry->symmetryCount; ++symmetry)
+    {
+        if (hashes[symmetry] < hashes[best]) best = symmetry;
+    }
+    return best;
+}
+
+/**
+ * @brief Gets the number of cells of the board.
+ * @return The number of rows times the number of columns.
+ */
+int TicTacToe::cellCount() const
+{
+    return geometry->rows * geometry->columns;
+}
+
+/**
+ * @brief Gets the number of rows of the board.
+ * @return The number of rows.
+ */
+int TicTacToe::getRows() const
+{
+    return geometry->rows;
+}
+
+/**
+ * @brief Gets the number of columns of the board.
+ * @return The number of columns.
+ */
+int TicTacToe::getColumns() const
+{
+    return geometry->columns;
+}
+
+/**
+ * @brief Gets the number of aligned markers winning the game.
+ * @return The length of a winning line.
+ */
+int TicTacToe::getAlignment() const
+{
+    return geometry->alignment;
+}
+
+/**
+ * @brief Gets the parameters of the game not given by its type, shared by the positions of the same variant.
+ * @return The rows, columns and alignment, e.g. `3x3/3`.
+ */
+std::string TicTacToe::getVariant() const
+{
+    return std::to_string(geometry->rows) + "x" + std::to_string(geometry->columns) + "/" + std::to_string(geometry->alignment);
 }
 
 /**
@@ -31,12 +291,24 @@ int TicTacToe::getCurrentPlayer() const
  */
 void TicTacToe::display() const
 {
-    for (const auto& row : board)
+    // The classic board is entered by cell number; larger ones by row and column, hence the labels.
+    const bool labelled = cellCount() > BOARD_SIZE * BOARD_SIZE;
+    if (labelled)
     {
-        for (const auto& cell : row)
+        std::cout << "   ";
+        for (int column = 1; column <= geometry->columns; ++column) std::cout << (column < 10 ? " " : "") << column << " ";
+        std::cout << "\n";
+    }
+
+    for (int row = 0; row < geometry->rows; ++row)
+    {
+        if (labelled) std::cout << (row + 1 < 10 ? " " : "") << row + 1 << " ";
+        for (int column = 0; column < geometry->columns; ++column)
         {
-            if (cell == PLAYER) std::cout << "X ";
-            else if (cell == AI) std::cout << "O ";
+            const int cell = row * geometry->columns + column;
+            if (labelled) std::cout << " ";
+            if (playerCells[cell]) std::cout << "X ";
+            else if (aiCells[cell]) std::cout << "O ";
             else  std::cout << ". ";
         }
         std::cout << "\n";
@@ -50,7 +322,7 @@ void TicTacToe::display() const
  */
 bool TicTacToe::isTerminal() const
 {
-    return getWinner() != 0 || getAvailableMoves().empty();
+    return getWinner() != 0 || !hasMoves();
 }
 
 /**
@@ -59,15 +331,42 @@ bool TicTacToe::isTerminal() const
  */
 std::vector<int> TicTacToe::getAvailableMoves() const
 {
-    std::vector<int> moves;
-    for (int i = 0; i < BOARD_SIZE; ++i)
+    MoveList moves;
+    generateMoves(moves);
+    return {moves.begin(), moves.end()};
+}
+
+/**
+ * @brief Writes all the available moves into a move list.
+ *
+ * On boards larger than `FULL_WIDTH_CELLS`, only the empty cells within `CANDIDATE_DISTANCE`
+ * of a marker are listed, or the central cell on an empty board.
+ * @param moves The list to fill with the indices of empty cells.
+ */
+void TicTacToe::generateMoves(MoveList &moves) const
+{
+    moves.clear();
+    const Bitboard occupied = playerCells | aiCells;
+    const bool pruned = cellCount() > FULL_WIDTH_CELLS;
+    if (pruned && filledCells == 0)
     {
-        for (int j = 0; j < BOARD_SIZE; ++j)
-        {
-            if (board[i][j] == EMPTY) moves.emplace_back(i * BOARD_SIZE + j);
-        }
+        moves.add(geometry->rows / 2 * geometry->columns + geometry->columns / 2);
+        return;
     }
-    return moves;
+
+    for (int cell = 0; cell < cellCount(); ++cell)
+    {
+        if (!occupied[cell] && (!pruned || (geometry->neighborhoods[cell] & occupied).any())) moves.add(cell);
+    }
+}
+
+/**
+ * @brief Checks if at least one cell is empty.
+ * @return true if a move can be made, false otherwise.
+ */
+bool TicTacToe::hasMoves() const
+{
+    return filledCells < cellCount();
 }
 
 /**
@@ -76,10 +375,12 @@ std::vector<int> TicTacToe::getAvailableMoves() const
  */
 void TicTacToe::makeMove(const int cellIndex)
 {
-    if (cellIndex >= 0 && cellIndex < BOARD_SIZE * BOARD_SIZE
-        && board[cellIndex / BOARD_SIZE][cellIndex % BOARD_SIZE] == EMPTY)
+    if (checkInput(cellIndex))
     {
-        board[cellIndex / BOARD_SIZE][cellIndex % BOARD_SIZE] = currentPlayer; // Place the current player's marker
+        (currentPlayer == PLAYER ? playerCells : aiCells).set(cellIndex); // Place the current player's marker
+        updateLines(cellIndex, currentPlayer == PLAYER, 1);
+        toggleHashes(cellIndex, currentPlayer == PLAYER);
+        ++filledCells;
         currentPlayer = (currentPlayer == PLAYER) ? AI : PLAYER; // Switch the player
     }
 }
@@ -90,26 +391,30 @@ void TicTacToe::makeMove(const int cellIndex)
  */
 void TicTacToe::undoMove(const int cellIndex)
 {
-    if (cellIndex >= 0 && cellIndex < BOARD_SIZE * BOARD_SIZE
-        && board[cellIndex / BOARD_SIZE][cellIndex % BOARD_SIZE] != EMPTY)
+    if (cellIndex >= 0 && cellIndex < cellCount() && (playerCells[cellIndex] || aiCells[cellIndex]))
     {
-        board[cellIndex / BOARD_SIZE][cellIndex % BOARD_SIZE] = EMPTY; // Clear the cell
+        const bool isPlayer = playerCells[cellIndex];
+        toggleHashes(cellIndex, isPlayer);
+        (isPlayer ? playerCells : aiCells).reset(cellIndex); // Clear the cell
+        updateLines(cellIndex, isPlayer, -1);
+        --filledCells;
         currentPlayer = (currentPlayer == PLAYER) ? AI : PLAYER; // Switch back the player
     }
 }
 
 /**
  * @brief Evaluates the current board state to calculate a score.
- * @return A score representing the evaluation of the board:
- *         10 for an AI win, -10 for a player win, 0 for a draw or ongoing game.
+ * @return WIN_SCORE if the AI wins, -WIN_SCORE if the player wins, 0 for a draw,
+ *         otherwise a heuristic score of the lines still open to one player only.
  */
 int TicTacToe::evaluate() const
 {
     const int winner = getWinner();
 
-    if (winner == AI) return 10; // AI wins
-    if (winner == PLAYER) return -10; // Player wins
-    return 0; // Draw or ongoing game
+    if (winner == AI) return WIN_SCORE; // AI wins
+    if (winner == PLAYER) return -WIN_SCORE; // Player wins
+    if (!hasMoves()) return 0; // Draw
+    return std::clamp(lineScore, 1 - WIN_SCORE, WIN_SCORE - 1);
 }
 
 /**
@@ -118,37 +423,125 @@ int TicTacToe::evaluate() const
  */
 int TicTacToe::getWinner() const
 {
-    // Check rows for a winner
-    for (const auto row : board)
+    if (playerLines > 0) return PLAYER;
+    if (aiLines > 0) return AI;
+
+    // No winner found
+    return 0;
+}
+
+/**
+ * @brief Gets the Zobrist hash of the current board.
+ * @return A 64-bit hash of the board and of the player to move.
+ */
+uint64_t TicTacToe::getHash() const
+{
+    return hashes[0];
+}
+
+/**
+ * @brief Gets the hash shared by the board and its images by the symmetries of the board.
+ * @return The smallest of the hashes of the images of the board.
+ */
+uint64_t TicTacToe::getCanonicalHash() const
+{
+    return hashes[canonicalSymmetry()];
+}
+
+/**
+ * @brief Maps a cell to the same cell on the canonical image of the board.
+ * @param move The index of the cell.
+ * @return The image of the cell by the symmetry giving the canonical image, or the move itself if it is not a cell.
+ */
+int TicTacToe::toCanonicalMove(const int move) const
+{
+    if (move < 0 || move >= cellCount()) return move;
+    return geometry->images[canonicalSymmetry()][move];
+}
+
+/**
+ * @brief Maps a cell of the canonical image of the board back to the board.
+ * @param move The index of a cell of the canonical image.
+ * @return The cell whose image by the symmetry giving the canonical image it is, or the move itself if it is not a cell.
+ */
+int TicTacToe::fromCanonicalMove(const int move) const
+{
+    if (move < 0 || move >= cellCount()) return move;
+    return geometry->preimages[canonicalSymmetry()][move];
+}
+
+/**
+ * @brief Encodes the board as a line of text.
+ *
+ * The cells are written as displayed: `X` for PLAYER, `O` for AI, `.` when empty.
+ * @return The rows separated by `/`, then the player to move and the alignment.
+ */
+std::string TicTacToe::toString() const
+{
+    std::string text;
+    for (int cell = 0; cell < cellCount(); ++cell)
     {
-        if (row[0] != EMPTY && row[0] == row[1] && row[1] == row[2])
-        {
-            return row[0];
-        }
+        if (cell > 0 && cell % geometry->columns == 0) text += '/';
+        text += playerCells[cell] ? 'X' : aiCells[cell] ? 'O' : '.';
     }
+    text += currentPlayer == PLAYER ? " X " : " O ";
+    text += std::to_string(geometry->alignment);
+    return text;
+}
+
+/**
+ * @brief Decodes a board encoded by toString().
+ *
+ * The size of the board is given by its rows. The markers are placed as if they had been played,
+ * so the hashes and the line counts are up to date.
+ * @param text The encoding: the rows from top to bottom separated by `/`, each cell being `X`,
+ *             `O` or `.`, then the player to move, `X` or `O`, then the number of aligned markers
+ *             winning the game. For instance `X.O/.X./... O 3`.
+ * @return The board, or nothing if the text is not a valid board.
+ */
+std::optional<TicTacToe> TicTacToe::fromString(const std::string &text)
+{
+    std::istringstream input(text);
+    std::string board, side, extra;
+    int alignment;
+    if (!(input >> board >> side >> alignment) || input >> extra || (side != "X" && side != "O")) return std::nullopt;
+
+    const std::size_t columns = board.find('/') == std::string::npos ? board.size() : board.find('/');
+    const std::size_t rows = (board.size() + 1) / (columns + 1);
+    if (columns == 0 || rows * (columns + 1) != board.size() + 1) return std::nullopt;
 
-    // Check columns for a winner
-    for (int j = 0; j < BOARD_SIZE; ++j)
+    std::optional<TicTacToe> game;
+    try
     {
-        if (board[0][j] != EMPTY && board[0][j] == board[1][j] && board[1][j] == board[2][j])
-        {
-            return board[0][j];
-        }
+        game.emplace(true, static_cast<int>(rows), static_cast<int>(columns), alignment);
     }
-
-    // Check diagonals for a winner
-    if (board[0][0] != EMPTY && board[0][0] == board[1][1] && board[1][1] == board[2][2])
+    catch (const std::invalid_argument &)
     {
-        return board[0][0];
+        return std::nullopt;
     }
 
-    if (board[0][2] != EMPTY && board[0][2] == board[1][1] && board[1][1] == board[2][0])
+    for (std::size_t row = 0; row < rows; ++row)
     {
-        return board[0][2];
+        if (row + 1 < rows && board[row * (columns + 1) + columns] != '/') return std::nullopt;
+        for (std::size_t column = 0; column < columns; ++column)
+        {
+            const char cell = board[row * (columns + 1) + column];
+            if (cell == 'X' || cell == 'O')
+            {
+                game->currentPlayer = cell == 'X' ? game->PLAYER : game->AI;
+                game->makeMove(static_cast<int>(row * columns + column));
+            }
+            else if (cell != '.') return std::nullopt;
+        }
     }
 
-    // No winner found
-    return 0;
+    // Each marker toggled the player to move in the hashes; only the final player counts.
+    game->currentPlayer = side == "X" ? game->PLAYER : game->AI;
+    if ((game->filledCells % 2 == 1) != (game->currentPlayer == game->AI))
+    {
+        for (uint64_t &hash : game->hashes) hash ^= Zobrist::SIDE_KEY;
+    }
+    return game;
 }
 
 /**
@@ -158,18 +551,26 @@ int TicTacToe::getWinner() const
  */
 bool TicTacToe::checkInput(const int input) const
 {
-    return input >= 0 && input < BOARD_SIZE * BOARD_SIZE
-    && board[input / BOARD_SIZE][input % BOARD_SIZE] == EMPTY;
+    return input >= 0 && input < cellCount() && !playerCells[input] && !aiCells[input];
 }
 
 /**
- * @brief Asks the player for their input.
+ * @brief Asks the player for their input: a cell number on the classic board, a row and a column otherwise.
  * @return The index of the cell chosen by the player.
  */
 int TicTacToe::askInput() const
 {
-    int x;
-    std::cout << "Enter your case: ";
-    std::cin >> x;
-    return x - 1;
+    if (cellCount() <= BOARD_SIZE * BOARD_SIZE)
+    {
+        int x;
+        std::cout << "Enter your case: ";
+        std::cin >> x;
+        return x - 1;
+    }
+
+    int row, column;
+    std::cout << "Enter the row and the column of your case: ";
+    std::cin >> row >> column;
+    if (row < 1 || row > geometry->rows || column < 1 || column > geometry->columns) return -1;
+    return (row - 1) * geometry->columns + column - 1;
 }
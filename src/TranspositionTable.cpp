@@ -0,0 +1,169 @@
+/**
+ * @file TranspositionTable.cpp
+ * @brief Implementation of the transposition table used by the search.
+ */
+
+#include "TranspositionTable.h"
+#include <algorithm>
+
+namespace
+{
+    /**
+     * @brief Packs the fields of an entry into one word.
+     * @param entry The entry to pack. Its key is ignored.
+     * @return The packed fields.
+     */
+    uint64_t pack(const TTEntry &entry)
+    {
+        return static_cast<uint64_t>(static_cast<uint16_t>(entry.score))
+             | static_cast<uint64_t>(static_cast<uint16_t>(entry.move)) << 16
+             | static_cast<uint64_t>(static_cast<uint16_t>(entry.depth)) << 32
+             | static_cast<uint64_t>(entry.bound) << 48;
+    }
+
+    /**
+     * @brief Unpacks the fields of an entry.
+     * @param key The key of the entry.
+     * @param data The packed fields.
+     * @return The entry.
+     */
+    TTEntry unpack(const uint64_t key, const uint64_t data)
+    {
+        TTEntry entry;
+        entry.key = key;
+        entry.score = static_cast<int16_t>(data & 0xFFFF);
+        entry.move = static_cast<int16_t>(data >> 16 & 0xFFFF);
+        entry.depth = static_cast<int16_t>(data >> 32 & 0xFFFF);
+        entry.bound = static_cast<Bound>(data >> 48 & 0xFF);
+        return entry;
+    }
+
+    /**
+     * @brief Gets the bound of a packed entry.
+     * @param data The packed fields.
+     * @return The bound, Bound::None for an empty slot.
+     */
+    Bound boundOf(const uint64_t data)
+    {
+        return static_cast<Bound>(data >> 48 & 0xFF);
+    }
+
+    /**
+     * @brief Gets the depth of a packed entry.
+     * @param data The packed fields.
+     * @return The remaining depth of the entry.
+     */
+    int depthOf(const uint64_t data)
+    {
+        return static_cast<int16_t>(data >> 32 & 0xFFFF);
+    }
+}
+
+/**
+ * @brief Constructs a transposition table.
+ * @param sizeMb The size of the table, in MiB. It is rounded down to a power of two buckets.
+ */
+TranspositionTable::TranspositionTable(const std::size_t sizeMb)
+{
+    resize(sizeMb);
+}
+
+/**
+ * @brief Changes the size of the table. All stored entries are lost.
+ * @param sizeMb The new size of the table, in MiB.
+ */
+void TranspositionTable::resize(const std::size_t sizeMb)
+{
+    const std::size_t requested = std::max<std::size_t>(sizeMb * 1024 * 1024 / sizeof(TTBucket), 1);
+
+    // Round down to a power of two so that the bucket index is a simple mask of the hash.
+    std::size_t count = 1;
+    while (count * 2 <= requested) count *= 2;
+
+    buckets = std::make_unique<TTBucket[]>(count);
+    indexMask = count - 1;
+}
+
+/**
+ * @brief Removes all stored entries.
+ */
+void TranspositionTable::clear()
+{
+    for (uint64_t i = 0; i <= indexMask; ++i)
+    {
+        for (auto& slot : buckets[i].slots)
+        {
+            slot.check.store(0, std::memory_order_relaxed);
+            slot.data.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+/**
+ * @brief Looks up a position.
+ * @param key The hash of the position.
+ * @param entry Receives the entry of the position when it is stored.
+ * @return true if the position is stored, false otherwise.
+ */
+bool TranspositionTable::probe(const uint64_t key, TTEntry &entry) const
+{
+    for (const auto& slot : buckets[key & indexMask].slots)
+    {
+        const uint64_t data = slot.data.load(std::memory_order_relaxed);
+        if (boundOf(data) != Bound::None && (slot.check.load(std::memory_order_relaxed) ^ data) == key)
+        {
+            entry = unpack(key, data);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Stores a search result.
+ * @param key The hash of the position.
+ * @param depth The remaining depth the position was searched to.
+ * @param bound How the score relates to the real score.
+ * @param score The score found by the search.
+ * @param move The best move found, or -1 if unknown.
+ */
+void TranspositionTable::store(const uint64_t key, const int depth, const Bound bound, const int score, const int move)
+{
+    TTBucket& bucket = buckets[key & indexMask];
+
+    // Reuse the entry of the same position, otherwise replace the shallowest one.
+    TTSlot* replaced = &bucket.slots[0];
+    int replacedDepth = TTEntry::MAX_DEPTH + 1;
+    for (auto& slot : bucket.slots)
+    {
+        const uint64_t data = slot.data.load(std::memory_order_relaxed);
+        if (boundOf(data) == Bound::None)
+        {
+            if (replacedDepth >= 0)
+            {
+                replaced = &slot;
+                replacedDepth = -1;
+            }
+            continue;
+        }
+        if ((slot.check.load(std::memory_order_relaxed) ^ data) == key)
+        {
+            replaced = &slot;
+            break;
+        }
+        if (depthOf(data) < replacedDepth)
+        {
+            replaced = &slot;
+            replacedDepth = depthOf(data);
+        }
+    }
+
+    TTEntry entry;
+    entry.score = static_cast<int16_t>(score);
+    entry.move = static_cast<int16_t>(move);
+    entry.depth = static_cast<int16_t>(std::min(depth, TTEntry::MAX_DEPTH));
+    entry.bound = bound;
+    const uint64_t data = pack(entry);
+    replaced->check.store(key ^ data, std::memory_order_relaxed);
+    replaced->data.store(data, std::memory_order_relaxed);
+}
@@ -0,0 +1,124 @@
+/**
+ * @file ArenaTest.cpp
+ * @brief Checks that an arena destroys its objects on reset and on destruction, and reuses its blocks.
+ */
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Arena.h"
+
+namespace
+{
+    int failures = 0; ///< The number of failed checks.
+
+    /**
+     * @brief Reports a failed check.
+     * @param passed Whether the check passed.
+     * @param message What was checked.
+     */
+    void check(const bool passed, const std::string &message)
+    {
+        if (passed) return;
+        std::cout << "FAIL: " << message << "\n";
+        ++failures;
+    }
+
+    /**
+     * @struct Tracked
+     * @brief An object recording its destruction, and owning heap memory the arena must release.
+     */
+    struct Tracked {
+        std::vector<int>* destroyed; ///< Receives the id of each destroyed object.
+        int id; ///< The id of the object.
+        std::string payload; ///< Memory leaked unless the destructor runs.
+
+        Tracked(std::vector<int>* destroyed, const int id)
+            : destroyed(destroyed), id(id), payload(64, static_cast<char>('a' + id % 26)) {}
+
+        ~Tracked() { destroyed->push_back(id); }
+    };
+
+    /**
+     * @brief Creates tracked objects, with trivially destructible arrays between them.
+     * @param arena The arena to create them in.
+     * @param destroyed Receives the ids of the destroyed objects.
+     * @param count The number of tracked objects.
+     * @return true if every object was constructed in place.
+     */
+    bool fill(Arena &arena, std::vector<int> &destroyed, const int count)
+    {
+        bool valid = true;
+        for (int id = 0; id < count; ++id)
+        {
+            const Tracked* object = arena.create<Tracked>(&destroyed, id);
+            valid = valid && object->id == id && reinterpret_cast<std::uintptr_t>(object) % alignof(Tracked) == 0;
+            uint64_t* numbers = arena.createArray<uint64_t>(3);
+            numbers[0] = numbers[1] = numbers[2] = id;
+        }
+        return valid;
+    }
+
+    /**
+     * @brief Checks that objects were destroyed once each, the last created first.
+     * @param destroyed The ids of the destroyed objects, in order.
+     * @param count The number of objects created.
+     * @return true if the order is `count - 1` down to 0.
+     */
+    bool reversed(const std::vector<int> &destroyed, const int count)
+    {
+        if (destroyed.size() != static_cast<std::size_t>(count)) return false;
+        for (int i = 0; i < count; ++i)
+        {
+            if (destroyed[i] != count - 1 - i) return false;
+        }
+        return true;
+    }
+}
+
+/**
+ * @brief Runs the test.
+ * @return int Exit status of the program: 1 if a check failed.
+ */
+int main()
+{
+    // Small blocks, so the objects and their cleanup records span many of them.
+    constexpr int COUNT = 100;
+    std::vector<int> destroyed;
+    {
+        Arena arena(256);
+        check(fill(arena, destroyed, COUNT), "the objects are constructed aligned");
+        check(destroyed.empty(), "no object is destroyed before the reset");
+
+        arena.reset();
+        check(reversed(destroyed, COUNT), "a reset destroys every object once, the last created first");
+        check(arena.bytesUsed() == 0, "a reset makes all the memory available");
+
+        const std::size_t reserved = arena.bytesReserved();
+        arena.reset();
+        check(destroyed.size() == COUNT, "a second reset destroys nothing more");
+
+        destroyed.clear();
+        check(fill(arena, destroyed, COUNT), "the objects are constructed aligned after a reset");
+        check(arena.bytesReserved() == reserved, "the blocks are reused after a reset");
+        check(destroyed.empty(), "no object is destroyed before the arena");
+    }
+    check(reversed(destroyed, COUNT), "the destructor of the arena destroys every object once, the last created first");
+
+    // An arena destroyed without allocating, or with trivially destructible objects only.
+    {
+        Arena arena;
+    }
+    {
+        Arena arena(64);
+        check(*arena.create<int>(7) == 7, "a trivially destructible object is constructed");
+        (void) arena.createArray<char>(1000);
+        check(arena.bytesReserved() >= 1000, "an allocation larger than a block gets its own block");
+    }
+
+    if (failures > 0) return 1;
+    std::cout << "OK\n";
+    return 0;
+}
@@ -0,0 +1,87 @@
+/**
+ * @file BatchAnalysisTest.cpp
+ * @brief Checks that the positions of a batch analysis do not depend on the other variants of the stream.
+ *
+ * The same positions of several board sizes, alignments and maximum takes are analyzed in one
+ * stream, then each on its own. The engines of a thread are reused along the stream, so an entry
+ * of one variant found in the table of another would change the results.
+ */
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "BatchAnalysis.h"
+
+namespace
+{
+    /**
+     * @brief Analyzes positions in one stream.
+     * @param positions The input lines.
+     * @param options The settings of the analysis.
+     * @return The output lines.
+     */
+    std::vector<std::string> analyze(const std::vector<std::string> &positions, const AnalysisOptions &options)
+    {
+        std::string text;
+        for (const std::string &position : positions) text += position + "\n";
+        std::istringstream input(text);
+        std::ostringstream output;
+        (void) analyzePositions(input, output, options);
+
+        std::vector<std::string> results;
+        std::istringstream lines(output.str());
+        for (std::string line; std::getline(lines, line);) results.push_back(line);
+        return results;
+    }
+}
+
+/**
+ * @brief Runs the test.
+ * @return int Exit status of the program: 1 if a position of the mixed stream got another result than alone.
+ */
+int main()
+{
+    const std::vector<std::string> positions = {
+        "sticks 9 O 3",
+        "sticks 12 O 4",
+        "sticks 9 O 3",
+        "tictactoe X../.../... O 2",
+        "tictactoe X../.../... O 3",
+        "tictactoe X../.../... O 2",
+        "tictactoe X.../..../..../.... O 3",
+        "connect4 ......./......./......./......./......./...X... O",
+        "sticks 12 O 4",
+        "tictactoe X../.../... O 3",
+    };
+
+    AnalysisOptions options;
+    options.threads = 1;
+    options.ttSizeMb = 1;
+    options.timeBudget = std::chrono::milliseconds(60000);
+    options.maxDepth = 8;
+
+    const std::vector<std::string> mixed = analyze(positions, options);
+    if (mixed.size() != positions.size())
+    {
+        std::cout << "FAIL: " << mixed.size() << " results for " << positions.size() << " positions\n";
+        return 1;
+    }
+
+    int failures = 0;
+    for (std::size_t i = 0; i < positions.size(); ++i)
+    {
+        const std::vector<std::string> alone = analyze({positions[i]}, options);
+        if (alone.size() != 1 || alone[0] != mixed[i])
+        {
+            std::cout << "FAIL: " << positions[i] << ": " << mixed[i] << " in the stream, "
+                      << (alone.empty() ? "nothing" : alone[0]) << " alone\n";
+            ++failures;
+        }
+    }
+
+    if (failures > 0) return 1;
+    std::cout << "OK: " << positions.size() << " positions\n";
+    return 0;
+}
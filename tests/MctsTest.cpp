@@ -0,0 +1,81 @@
+/**
+ * @file MctsTest.cpp
+ * @brief Checks that the Monte Carlo search plays a winning move when one is available.
+ *
+ * In each position the player to move wins at once, while the opponent also threatens to win:
+ * blocking the threat instead would be a mistake. Both players are tried, since the rewards of
+ * a node are counted for the player who moved into it.
+ */
+
+#include <iostream>
+#include <string>
+
+#include "Connect4.h"
+#include "Mcts.h"
+#include "TicTacToe.h"
+
+namespace
+{
+    int failures = 0; ///< The number of failed checks.
+
+    /**
+     * @brief Reports a failed check.
+     * @param passed Whether the check passed.
+     * @param message What was checked.
+     */
+    void check(const bool passed, const std::string &message)
+    {
+        if (passed) return;
+        std::cout << "FAIL: " << message << "\n";
+        ++failures;
+    }
+
+    /**
+     * @brief Searches a position with several seeds and thread counts.
+     * @tparam TGame The game type.
+     * @param position The encoding of the position, see Game::toString().
+     * @param winningMove The move winning the game at once.
+     */
+    template <typename TGame>
+    void checkWin(const std::string &position, const int winningMove)
+    {
+        std::optional<TGame> game = TGame::fromString(position);
+        check(game.has_value(), position + ": the position is valid");
+        if (!game) return;
+
+        for (const int threads : {1, 2})
+        {
+            for (const uint64_t seed : {1, 2, 3})
+            {
+                SearchLimits limits;
+                limits.playouts = 2000;
+                limits.threads = threads;
+                Mcts<TGame> engine(16, seed);
+                const SearchResult result = engine.findBestMove(*game, limits);
+                const std::string name = position + ", seed " + std::to_string(seed) + ", " + std::to_string(threads) + " threads";
+                check(result.move == winningMove, name + ": plays " + std::to_string(result.move) + " instead of the win");
+                check(game->toString() == position, name + ": the search restores the game");
+            }
+        }
+    }
+}
+
+/**
+ * @brief Runs the test.
+ * @return int Exit status of the program: 1 if a check failed.
+ */
+int main()
+{
+    // The AI completes the top row; the player threatens the middle one.
+    checkWin<TicTacToe>("OO./XX./... O 3", 2);
+    // The player completes the middle row; the AI threatens the top one.
+    checkWin<TicTacToe>("OO./XX./O.. X 3", 5);
+    // The AI completes the bottom row; the player threatens the last column.
+    checkWin<Connect4>("......./......./......./......X/......X/OOO...X O", 3);
+    // The player completes the last column; the AI threatens the bottom row.
+    checkWin<Connect4>("......./......./......./......X/O.....X/OOO...X X", 6);
+
+    if (failures > 0) return 1;
+    std::cout << "OK\n";
+    return 0;
+}
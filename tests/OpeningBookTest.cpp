@@ -0,0 +1,138 @@
+/**
+ * @file OpeningBookTest.cpp
+ * @brief Checks that a book reads back what was written, in both formats, and that damaged files are rejected.
+ *
+ * The book is mapped from a file given by the user, so a file cut short must fail to open
+ * instead of letting a probe read past the mapping.
+ */
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "OpeningBook.h"
+
+namespace
+{
+    int failures = 0; ///< The number of failed checks.
+
+    /**
+     * @brief Reports a failed check.
+     * @param passed Whether the check passed.
+     * @param message What was checked.
+     */
+    void check(const bool passed, const std::string &message)
+    {
+        if (passed) return;
+        std::cout << "FAIL: " << message << "\n";
+        ++failures;
+    }
+
+    /**
+     * @brief Reads a whole file.
+     * @param path The path of the file.
+     * @return The bytes of the file.
+     */
+    std::vector<char> readFile(const std::string &path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    }
+
+    /**
+     * @brief Writes the first bytes of a file to another file.
+     * @param path The path of the file to create.
+     * @param bytes The bytes of the original file.
+     * @param size The number of bytes to keep.
+     */
+    void writePrefix(const std::string &path, const std::vector<char> &bytes, const std::size_t size)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(bytes.data(), static_cast<std::streamsize>(size));
+    }
+
+    /**
+     * @brief Writes a book, reads it back and truncates it.
+     * @param format The layout of the book.
+     * @param entries The records, with distinct keys.
+     * @param directory Where the files are written.
+     */
+    void testFormat(const BookFormat format, const std::vector<BookEntry> &entries, const std::filesystem::path &directory)
+    {
+        const std::string name = format == BookFormat::Flat ? "flat" : "compressed";
+        const std::string path = (directory / ("book-" + name + ".bin")).string();
+        const std::string cutPath = (directory / ("book-" + name + "-cut.bin")).string();
+
+        // The duplicate key keeps the first record written.
+        std::vector<BookEntry> written = entries;
+        written.push_back({entries.front().key, 1234, 5});
+        check(OpeningBook::write(path, written, format), name + ": the book is written");
+
+        OpeningBook book(path);
+        check(book.isOpen(), name + ": the book opens");
+        check(book.size() == entries.size(), name + ": the book holds every distinct key once");
+
+        std::size_t found = 0;
+        for (const BookEntry &expected : entries)
+        {
+            BookEntry entry;
+            if (book.probe(expected.key, entry) && entry.key == expected.key
+                && entry.score == expected.score && entry.move == expected.move) ++found;
+        }
+        check(found == entries.size(), name + ": every key reads back its record, "
+              + std::to_string(found) + " of " + std::to_string(entries.size()));
+
+        // Keys between, before and after the records are absent: the second key is far from the first.
+        BookEntry entry;
+        check(!book.probe(entries.front().key + 1, entry), name + ": a key between two records is absent");
+        check(!book.probe(0, entry) && !book.probe(UINT64_MAX, entry), name + ": the keys outside the book are absent");
+        book.close();
+        check(!book.isOpen() && !book.probe(entries.front().key, entry), name + ": a closed book is empty");
+
+        // Every prefix of the file is rejected.
+        const std::vector<char> bytes = readFile(path);
+        std::size_t opened = 0;
+        for (std::size_t size = 0; size < bytes.size(); ++size)
+        {
+            writePrefix(cutPath, bytes, size);
+            if (OpeningBook(cutPath).isOpen()) ++opened;
+        }
+        check(opened == 0, name + ": " + std::to_string(opened) + " truncated files open");
+
+        std::filesystem::remove(path);
+        std::filesystem::remove(cutPath);
+    }
+}
+
+/**
+ * @brief Runs the test.
+ * @return int Exit status of the program: 1 if a check failed.
+ */
+int main()
+{
+    // Sorted distinct keys, with close and distant neighbours so the deltas take one to eight bytes.
+    std::mt19937_64 random(42);
+    std::vector<BookEntry> entries;
+    uint64_t key = 1000;
+    for (int i = 0; i < 300; ++i)
+    {
+        key += i % 3 == 0 ? 1 + random() % 4 : 1 + random() % (UINT64_MAX / 1024);
+        entries.push_back({key, static_cast<int16_t>(static_cast<int>(random() % 2001) - 1000), static_cast<int16_t>(static_cast<int>(random() % 10) - 1)});
+    }
+
+    const std::filesystem::path directory = std::filesystem::temp_directory_path();
+    testFormat(BookFormat::Flat, entries, directory);
+    testFormat(BookFormat::Compressed, entries, directory);
+
+    OpeningBook missing((directory / "book-missing.bin").string());
+    check(!missing.isOpen(), "a missing file does not open");
+
+    if (failures > 0) return 1;
+    std::cout << "OK\n";
+    return 0;
+}
@@ -0,0 +1,105 @@
+/**
+ * @file SticksTest.cpp
+ * @brief Checks the Sticks game, its solver and its hashes against each other.
+ *
+ * The solver and the alpha-beta search must agree with the known result: the player to move
+ * loses exactly when the number of sticks is one more than a multiple of `maxTake + 1`.
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "AlphaBeta.h"
+#include "SticksGame.h"
+#include "SticksSolver.h"
+
+namespace
+{
+    int failures = 0; ///< The number of failed checks.
+
+    /**
+     * @brief Reports a failed check.
+     * @param passed Whether the check passed.
+     * @param message What was checked.
+     */
+    void check(const bool passed, const std::string &message)
+    {
+        if (passed) return;
+        std::cout << "FAIL: " << message << "\n";
+        ++failures;
+    }
+}
+
+/**
+ * @brief Runs the test.
+ * @return int Exit status of the program: 1 if a check failed.
+ */
+int main()
+{
+    // The moves index the tables of MAX_MOVES entries of the move orderer, so a take of MAX_MOVES is rejected.
+    bool rejected = false;
+    try
+    {
+        (void) SticksGame(false, 600, MAX_MOVES);
+    }
+    catch (const std::invalid_argument &)
+    {
+        rejected = true;
+    }
+    check(rejected, "a maximum take of MAX_MOVES is rejected by the constructor");
+    check(!SticksGame::fromString("600 O " + std::to_string(MAX_MOVES)), "a maximum take of MAX_MOVES is rejected by fromString");
+
+    // The largest take is searched with every move legal; the engine is on the heap, as in the servers.
+    SticksGame game(false, 600, MAX_TAKE_LIMIT);
+    auto engine = std::make_unique<AlphaBeta<SticksGame>>(1);
+    const SearchResult result = engine->findBestMove(game, SearchLimits::defaults<SticksGame>());
+    check(result.move >= 1 && result.move <= MAX_TAKE_LIMIT, "the search of the largest take returns a legal move");
+    check(game.getRemainingSticks() == 600, "the search restores the game");
+
+    // The solver, the search and the known result agree, up to the largest take.
+    for (const int take : {1, 2, 3, 4, 7, MAX_TAKE_LIMIT})
+    {
+        const int maxSticks = take == MAX_TAKE_LIMIT ? 2 * MAX_TAKE_LIMIT + 4 : 40;
+        const SticksSolver solver(maxSticks, take);
+        AlphaBeta<SticksGame> search(1);
+        for (int sticks = 1; sticks <= maxSticks; ++sticks)
+        {
+            const std::string name = std::to_string(sticks) + " sticks, take " + std::to_string(take);
+            const bool winning = sticks % (take + 1) != 1;
+            check(solver.isWinning(sticks) == winning, name + ": solver result");
+
+            SticksGame position(false, sticks, take); // The AI, maximizing, is to move.
+            const SearchResult searched = search.findBestMove(position, SearchLimits::defaults<SticksGame>());
+            check((searched.score > 0) == winning, name + ": search result");
+
+            const int move = solver.getBestMove(position);
+            check(move >= 1 && move <= std::min(take, sticks), name + ": solver move is legal");
+            if (winning)
+            {
+                check((sticks - move) % (take + 1) == 1, name + ": solver move leaves a lost count");
+            }
+        }
+    }
+
+    // The hash depends on the maximum take, and moves leave that part untouched.
+    check(SticksGame(true, 9, 3).getHash() != SticksGame(true, 9, 4).getHash(), "the hashes of two takes differ");
+    SticksGame first(true, 12, 4);
+    SticksGame second(true, 12, 4);
+    first.makeMove(1);
+    first.makeMove(2);
+    second.makeMove(2);
+    second.makeMove(1);
+    check(first.getHash() == second.getHash(), "transposed moves give the same hash");
+    check(first.getHash() == SticksGame(true, 9, 4).getHash(), "a played position hashes like a new one");
+    first.undoMove(2);
+    first.undoMove(1);
+    check(first.getHash() == SticksGame(true, 12, 4).getHash(), "undone moves restore the hash");
+    check(SticksGame::fromString("9 X 3")->getHash() == SticksGame(true, 9, 3).getHash(), "a decoded position hashes like a new one");
+
+    if (failures > 0) return 1;
+    std::cout << "OK\n";
+    return 0;
+}
@@ -0,0 +1,180 @@
+/**
+ * @file BookGenerator.cpp
+ * @brief Generates the Connect 4 opening book read by `OpeningBook`.
+ *
+ * Every position reachable in at most the given number of plies, with the AI to move, is
+ * enumerated once (transpositions and mirror images share a canonical hash) and searched to a
+ * fixed depth. The moves are stored as moves of the canonical image. The
+ * positions are shared by all cores, each searching with its own engine.
+ *
+ * The results are appended to `<output>.checkpoint` as they are found. An interrupted run started
+ * again with the same output skips the positions already in the checkpoint, which is removed once
+ * the compressed book is written.
+ *
+ * Usage: `book_generator <output> [plies] [depth] [threads] [hash MiB]`
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "AlphaBeta.h"
+#include "Connect4.h"
+#include "OpeningBook.h"
+#include "ThreadPool.h"
+
+namespace
+{
+    constexpr int CHECKPOINT_INTERVAL = 256; ///< The number of results between two checkpoint flushes.
+
+    /**
+     * @struct Position
+     * @brief A position to solve, with the way to reach it.
+     */
+    struct Position {
+        uint64_t key; ///< The canonical hash of the position.
+        bool aiStarts; ///< Whether the AI played the first move.
+        std::string moves; ///< The columns played from the empty board, as digits.
+    };
+
+    /**
+     * @brief Collects the positions with the AI to move reachable from a game.
+     * @param game The current position, restored before returning.
+     * @param moves The columns played to reach the position.
+     * @param aiStarts Whether the AI played the first move.
+     * @param plies The number of moves after which the enumeration stops.
+     * @param seen The canonical hashes of the positions already visited.
+     * @param positions Receives the positions to solve.
+     */
+    void enumerate(Connect4 &game, std::string &moves, const bool aiStarts, const int plies,
+                   std::unordered_set<uint64_t> &seen, std::vector<Position> &positions)
+    {
+        // A transposition or a mirror image leads to the same subtree, which was already enumerated.
+        if (game.isTerminal() || !seen.insert(game.getCanonicalHash()).second) return;
+        if (game.getCurrentPlayer() == game.AI) positions.push_back({game.getCanonicalHash(), aiStarts, moves});
+        if (static_cast<int>(moves.size()) == plies) return;
+
+        MoveList columns;
+        game.generateMoves(columns);
+        for (const auto column : columns)
+        {
+            game.makeMove(column);
+            moves.push_back(static_cast<char>('0' + column));
+            enumerate(game, moves, aiStarts, plies, seen, positions);
+            moves.pop_back();
+            game.undoMove(column);
+        }
+    }
+
+    /**
+     * @brief Reads the results of an interrupted run.
+     * @param path The path of the checkpoint file.
+     * @return The results in the file, without the last line if it was cut.
+     */
+    std::vector<BookEntry> readCheckpoint(const std::string &path)
+    {
+        std::vector<BookEntry> entries;
+        std::ifstream file(path);
+        uint64_t key;
+        int score, move;
+        while (file >> key >> score >> move)
+        {
+            if (move >= 0 && move < Connect4::WIDTH) entries.push_back({key, static_cast<int16_t>(score), static_cast<int16_t>(move)});
+        }
+        return entries;
+    }
+}
+
+/**
+ * @brief Generates the opening book.
+ *
+ * @param argc The number of command-line arguments.
+ * @param argv The command-line arguments: the output path, then optionally the number of plies,
+ *             the search depth, the number of threads and the table size of each thread.
+ * @return int Exit status of the program.
+ */
+int main(const int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        std::cout << "Usage: book_generator <output> [plies=6] [depth=10] [threads] [hash MiB=16]\n";
+        return 1;
+    }
+    const std::string output = argv[1];
+    const int plies = argc > 2 ? std::stoi(argv[2]) : 6;
+    const int depth = argc > 3 ? std::stoi(argv[3]) : 10;
+    const int threads = argc > 4 ? std::stoi(argv[4]) : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    const std::size_t ttSizeMb = argc > 5 ? std::stoul(argv[5]) : DEFAULT_TT_SIZE_MB;
+    const std::string checkpointPath = output + ".checkpoint";
+
+    std::vector<Position> positions;
+    std::unordered_set<uint64_t> seen;
+    for (const bool aiStarts : {true, false})
+    {
+        Connect4 game(!aiStarts);
+        std::string moves;
+        enumerate(game, moves, aiStarts, plies, seen, positions);
+    }
+
+    std::vector<BookEntry> entries = readCheckpoint(checkpointPath);
+    std::unordered_set<uint64_t> solved;
+    for (const BookEntry &entry : entries) solved.insert(entry.key);
+    std::erase_if(positions, [&](const Position &position) { return solved.contains(position.key); });
+    std::cout << positions.size() << " positions to solve, " << entries.size() << " read from the checkpoint.\n";
+
+    std::ofstream checkpoint(checkpointPath, std::ios::app);
+    std::mutex resultsMutex;
+    std::atomic<std::size_t> nextPosition{0};
+    std::size_t completed = 0;
+
+    SearchLimits limits;
+    limits.maxDepth = depth;
+
+    const auto solve = [&]
+    {
+        AlphaBeta<Connect4> engine(ttSizeMb);
+        for (std::size_t i = nextPosition++; i < positions.size(); i = nextPosition++)
+        {
+            const Position &position = positions[i];
+            Connect4 game(!position.aiStarts);
+            for (const char column : position.moves) game.makeMove(column - '0');
+
+            const int move = game.toCanonicalMove(engine.getBestMove(game, limits));
+            const BookEntry entry{position.key, static_cast<int16_t>(engine.getBestScore()), static_cast<int16_t>(move)};
+
+            std::lock_guard lock(resultsMutex);
+            entries.push_back(entry);
+            checkpoint << entry.key << ' ' << entry.score << ' ' << entry.move << '\n';
+            if (++completed % CHECKPOINT_INTERVAL == 0)
+            {
+                checkpoint.flush();
+                std::cout << completed << " / " << positions.size() << "\n";
+            }
+        }
+    };
+
+    {
+        ThreadPool pool(threads);
+        std::vector<std::future<void>> workers;
+        for (int i = 0; i < threads; ++i) workers.push_back(pool.submit(solve));
+        for (auto &worker : workers) worker.get();
+    }
+    checkpoint.close();
+
+    if (!OpeningBook::write(output, entries))
+    {
+        std::cout << "Could not write " << output << ", the results are kept in " << checkpointPath << ".\n";
+        return 1;
+    }
+    std::filesystem::remove(checkpointPath);
+    std::cout << "Wrote " << entries.size() << " positions to " << output << " ("
+              << std::filesystem::file_size(output) << " bytes).\n";
+    return 0;
+}